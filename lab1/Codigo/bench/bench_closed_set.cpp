@@ -0,0 +1,129 @@
+// Benchmark de los backends del closed set (Robin Hood vs Swiss table).
+// Para cada instancia se genera una traza deterministica de operaciones con
+// una exploracion en anchura desde el estado cero (contains por cada sucesor y
+// insert de los nuevos), y despues se reproduce la misma traza en cada
+// backend midiendo solo el tiempo del closed set
+//
+// uso: ./bench_closed_set examples/*.txt   (o make bench)
+#include "../include/ClosedSet.h"
+#include "../include/StateEncoding.h"
+#include "../include/StatePool.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+static constexpr unsigned int MAX_OPERATIONS = 3000000;
+static constexpr unsigned int REPETITIONS = 3;
+
+struct Operation {
+    State *state;
+    bool is_insert;
+};
+
+// exploracion en anchura hasta llenar la traza
+static unsigned int buildTrace(const State &max_state, StatePool &pool,
+                               Operation *trace) {
+    HashTable seen;
+    unsigned int *zero = new unsigned int[max_state.size]();
+    State *root = pool.allocate(zero, 0, 0, nullptr);
+    delete[] zero;
+
+    unsigned int queue_capacity = MAX_OPERATIONS + 1;
+    State **queue = new State *[queue_capacity];
+    unsigned int head = 0, tail = 0;
+    unsigned int count = 0;
+
+    seen.insert(root);
+    queue[tail++] = root;
+    trace[count++] = {root, true};
+
+    while (head < tail && count + 2 <= MAX_OPERATIONS) {
+        State *current = queue[head++];
+        unsigned int num_successors = 0;
+        State **successors = current->generateSuccessors(
+            max_state.jugs, num_successors, &pool);
+        for (unsigned int i = 0; i < num_successors; i++) {
+            if (count + 2 > MAX_OPERATIONS) {
+                break;
+            }
+            trace[count++] = {successors[i], false};
+            if (seen.insert(successors[i])) {
+                trace[count++] = {successors[i], true};
+                if (tail < queue_capacity) {
+                    queue[tail++] = successors[i];
+                }
+            }
+        }
+        delete[] successors;
+    }
+
+    seen.clear();
+    delete[] queue;
+    return count;
+}
+
+// devuelve el mejor tiempo en ms de REPETITIONS corridas
+static double replay(ClosedSetBackend backend, const Operation *trace,
+                     unsigned int count, unsigned int &hits) {
+    double best = 0.0;
+    for (unsigned int r = 0; r < REPETITIONS; r++) {
+        ClosedSet closed(backend);
+        hits = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (unsigned int i = 0; i < count; i++) {
+            if (trace[i].is_insert) {
+                closed.insert(trace[i].state);
+            } else if (closed.contains(trace[i].state)) {
+                hits++;
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms =
+            std::chrono::duration<double, std::milli>(end - start).count();
+        if (r == 0 || ms < best) {
+            best = ms;
+        }
+        closed.clear();
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "uso: " << argv[0] << " examples/*.txt\n";
+        return 1;
+    }
+
+    Operation *trace = new Operation[MAX_OPERATIONS];
+    std::cout << "instancia                    ops     robin hood(ms)  "
+                 "swiss(ms)  speedup\n";
+
+    for (int a = 1; a < argc; a++) {
+        State max_state, target_state;
+        if (!State::readStatesFromFile(argv[a], &max_state, &target_state)) {
+            continue;
+        }
+        StateEncoding encoding(max_state.jugs, max_state.size);
+        StatePool pool(max_state.size, &encoding);
+        unsigned int count = buildTrace(max_state, pool, trace);
+
+        unsigned int hits_rh = 0, hits_sw = 0;
+        double rh =
+            replay(ClosedSetBackend::ROBIN_HOOD, trace, count, hits_rh);
+        double sw = replay(ClosedSetBackend::SWISS, trace, count, hits_sw);
+        if (hits_rh != hits_sw) {
+            std::cerr << "Error: los backends no coinciden en " << argv[a]
+                      << "\n";
+            delete[] trace;
+            return 1;
+        }
+
+        std::string name = argv[a];
+        name.resize(28, ' ');
+        std::cout << name << " " << count << "  " << rh << "  " << sw << "  "
+                  << (sw > 0 ? rh / sw : 0.0) << "x\n";
+    }
+
+    delete[] trace;
+    return 0;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "HashTable.h"
+#include "Heap.h"
+#include "PatternDatabase.h"
+#include "Search.h"
+#include "SearchLimits.h"
+#include "StateEncoding.h"
+#include "StatePool.h"
+#include <functional>
+
+// Weighted A* con reinicios y pesos cada vez menores. La primera ronda es
+// greedy por calculateHeuristic para tener una solucion rapido; las
+// siguientes ordenan por g + w * h con la cota admisible y podan todo lo que
+// con g + h no puede mejorar la mejor solucion (incumbente). Cada mejora se
+// publica por el callback. Se corta por los topes de options.limits y se
+// devuelve la incumbente; si una ronda se agota o termina con w = 1, la
+// incumbente es optima
+class AnytimeSearch {
+    public:
+    typedef std::function<void(const Search::Path &path, float weight)>
+        ImprovementCallback;
+
+    // resultado de una ronda
+    enum class RoundResult { IMPROVED, EXHAUSTED, INTERRUPTED };
+
+    // pesos de las rondas despues de la greedy
+    static const float WEIGHTS[];
+    static const unsigned int NUM_WEIGHTS;
+    // peso fijo con que se escala w * h a entero
+    static constexpr unsigned int WEIGHT_SCALE = 16;
+
+    AnytimeSearch(State *initial_state, State *target_state,
+                  const unsigned int *capacities,
+                  const Search::Options &options = Search::Options());
+    ~AnytimeSearch();
+
+    // el Path que recibe el callback es solo una vista, no se libera
+    void setImprovementCallback(const ImprovementCallback &callback);
+    // los estados del Path viven en incumbent_pool, son validos hasta
+    // destruir el AnytimeSearch
+    Search::Path findPath();
+
+    const unsigned int *capacities;
+    State *initial_state;
+    State *target_state;
+    Search::Options options;
+    StateEncoding encoding;
+    ZobristHash zobrist;
+    // estados de la ronda actual, se vacia en cada reinicio
+    StatePool state_pool;
+    // copia del mejor camino, sobrevive a los reinicios
+    StatePool incumbent_pool;
+    PatternDatabase *pdb;
+    PairingHeap open_list;
+    HashTable open_index;
+    HashTable closed_list;
+    State **incumbent;
+    unsigned int incumbent_length;
+    bool proven_optimal;
+    size_t expanded;
+    ImprovementCallback on_improvement;
+    // se reinicia en cada findPath, vale para todas las rondas
+    LimitGovernor governor;
+
+    static constexpr unsigned int NO_INCUMBENT = ~0u;
+
+    RoundResult runRound(float weight);
+    void evaluate(State *state, float weight);
+    size_t reservedBytes() const;
+    void publish(State *goal, float weight);
+    void resetRound();
+    Search::Path incumbentPath() const;
+};
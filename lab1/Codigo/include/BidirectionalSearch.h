@@ -0,0 +1,61 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "HashTable.h"
+#include "Search.h"
+#include "SearchLimits.h"
+#include "StateEncoding.h"
+#include "StatePool.h"
+
+// BFS bidireccional por capas: un frente avanza desde el estado inicial con
+// generateSuccessors y el otro retrocede desde el objetivo con
+// generatePredecessors. Siempre se expande la capa completa del frente mas
+// chico y, si en esa capa se tocan, se queda el punto de encuentro de menor
+// largo total, asi el camino es optimo en numero de movimientos. En el frente
+// de atras el parent de un estado es el siguiente hacia el objetivo
+class BidirectionalSearch {
+    public:
+    // tope de estados vivos en el pool si limits no pone uno menor
+    static constexpr size_t DEFAULT_MAX_STATES = 8000000;
+
+    struct Frontier {
+        State **states;
+        size_t count;
+        size_t capacity;
+
+        Frontier();
+        ~Frontier();
+        void push(State *state);
+        void swap(Frontier &other);
+    };
+
+    BidirectionalSearch(State *initial_state, State *target_state,
+                        const unsigned int *capacities,
+                        size_t max_states = DEFAULT_MAX_STATES,
+                        const SearchLimits &limits = SearchLimits());
+    ~BidirectionalSearch();
+
+    // los estados del Path viven en el pool, son validos hasta destruir el
+    // BidirectionalSearch
+    Search::Path findPath();
+
+    const unsigned int *capacities;
+    SearchLimits limits;
+    StateEncoding encoding;
+    ZobristHash zobrist;
+    StatePool state_pool;
+    State *start_state;
+    State *goal_state;
+    // todo lo generado por cada lado, para no repetir y para el encuentro
+    HashTable forward_seen;
+    HashTable backward_seen;
+    Frontier forward_frontier;
+    Frontier backward_frontier;
+    size_t expanded;
+    LimitGovernor governor;
+
+    bool expandLayer(bool forward, State *&forward_meet,
+                     State *&backward_meet);
+    size_t reservedBytes() const;
+    Search::Path reconstructPath(State *forward_meet,
+                                 State *backward_meet) const;
+};
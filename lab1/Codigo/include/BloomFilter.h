@@ -0,0 +1,27 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include <cstddef>
+#include <cstdint>
+
+// Filtro de Bloom sobre hashes de 64 bits: num_hashes posiciones por doble
+// hashing (h1 + i * h2) en un arreglo de bits de tamano potencia de dos. No
+// tiene falsos negativos; un falso positivo solo cuesta una consulta de mas
+class BloomFilter {
+    public:
+    static constexpr unsigned int DEFAULT_HASHES = 4;
+
+    // usa a lo mas max_bytes, con un minimo de una palabra
+    BloomFilter(size_t max_bytes, unsigned int num_hashes = DEFAULT_HASHES);
+    ~BloomFilter();
+
+    void add(uint64_t hash);
+    bool mayContain(uint64_t hash) const;
+    void clear();
+    size_t reservedBytes() const;
+
+    uint64_t *bits;
+    size_t num_words;
+    // num_words * 64 - 1
+    uint64_t mask;
+    unsigned int num_hashes;
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "State.h"
+#include <cstddef>
+
+// Open list para prioridades enteras: un bucket por valor de weight y un
+// cursor al menor bucket no vacio. push y pop son O(1) amortizado mientras
+// los pesos no se alejen mucho del cursor, sin nodos ni mezclas de punteros.
+// Dentro de un mismo peso se saca en orden FIFO o LIFO
+class BucketQueue {
+    public:
+    enum class TieBreak { FIFO, LIFO };
+
+    static constexpr unsigned int INITIAL_BUCKETS = 1024;
+    static constexpr unsigned int INITIAL_BUCKET_CAPACITY = 16;
+
+    struct Bucket {
+        State **items;
+        unsigned int head;
+        unsigned int count;
+        unsigned int capacity;
+    };
+
+    BucketQueue(TieBreak tie_break = TieBreak::LIFO);
+    ~BucketQueue();
+
+    void push(State *state);
+    State *pop();
+    State *peek() const;
+    void clear();
+    bool empty() const;
+    // aproximada: los buckets y un puntero por estado encolado
+    size_t reservedBytes() const;
+
+    TieBreak tie_break;
+    Bucket *buckets;
+    unsigned int num_buckets;
+    unsigned int min_bucket;
+    size_t size;
+
+    void growBuckets(unsigned int weight);
+    unsigned int firstNonEmpty() const;
+};
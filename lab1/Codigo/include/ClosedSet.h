@@ -0,0 +1,82 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "CompactClosedSet.h"
+#include "HashTable.h"
+#include "State.h"
+#include "SwissTable.h"
+
+// backend por defecto del closed set, se puede cambiar al compilar con
+// make swiss (-DCLOSED_SET_SWISS) o en tiempo de ejecucion por Search::Options.
+// COMPACT guarda registros compactos en vez de punteros a State, y Search
+// rehace el camino al final
+enum class ClosedSetBackend { ROBIN_HOOD, SWISS, COMPACT };
+
+#ifdef CLOSED_SET_SWISS
+constexpr ClosedSetBackend DEFAULT_CLOSED_SET_BACKEND = ClosedSetBackend::SWISS;
+#else
+constexpr ClosedSetBackend DEFAULT_CLOSED_SET_BACKEND =
+    ClosedSetBackend::ROBIN_HOOD;
+#endif
+
+// Fachada del closed set, solo se reserva la tabla del backend elegido. Los
+// metodos son inline porque se llaman una vez por sucesor
+class ClosedSet {
+    public:
+    ClosedSet(ClosedSetBackend backend = DEFAULT_CLOSED_SET_BACKEND,
+              const HashTable::Config &config = HashTable::Config());
+    ~ClosedSet();
+
+    void setBackend(ClosedSetBackend backend);
+    static const char *backendName(ClosedSetBackend backend);
+
+    inline bool insert(State *state) {
+        if (robin_hood) {
+            return robin_hood->insert(state);
+        }
+        return swiss ? swiss->insert(state) : compact->insert(state);
+    }
+    inline bool contains(const State *state) const {
+        if (robin_hood) {
+            return robin_hood->contains(state);
+        }
+        return swiss ? swiss->contains(state) : compact->contains(state);
+    }
+    inline void removeState(State *state) {
+        if (robin_hood) {
+            robin_hood->removeState(state);
+        } else if (swiss) {
+            swiss->removeState(state);
+        } else {
+            compact->removeState(state);
+        }
+    }
+    inline void clear() {
+        if (robin_hood) {
+            robin_hood->clear();
+        } else if (swiss) {
+            swiss->clear();
+        } else {
+            compact->clear();
+        }
+    }
+    inline size_t size() const {
+        if (robin_hood) {
+            return robin_hood->size;
+        }
+        return swiss ? swiss->size : compact->size;
+    }
+    inline size_t reservedBytes() const {
+        if (robin_hood) {
+            return robin_hood->reservedBytes();
+        }
+        return swiss ? swiss->reservedBytes() : compact->reservedBytes();
+    }
+
+    ClosedSetBackend backend;
+    HashTable::Config config;
+    HashTable *robin_hood;
+    SwissTable *swiss;
+    CompactClosedSet *compact;
+
+    void release();
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "HashTable.h"
+#include "State.h"
+#include <cstddef>
+#include <cstdint>
+
+// Closed set de registros compactos: por estado cerrado se guarda su llave
+// empaquetada, el indice del registro del padre (32 bits) y el codigo del
+// movimiento que lo genero (State::Move::code, 16 bits), en arreglos
+// paralelos. El State completo se puede devolver al pool despues de
+// expandirlo, y el camino se rehace al final repitiendo los movimientos desde
+// el estado inicial. El indice es una tabla con sondeo lineal de pares (hash
+// de 32 bits, registro); la llave solo se compara si el hash coincide
+class CompactClosedSet {
+    public:
+    static constexpr size_t INITIAL_NODES = 1u << 12;
+    static constexpr size_t INITIAL_SLOTS = 1u << 16;
+    static constexpr float MAX_LOAD_FACTOR = 0.7f;
+
+    struct Slot {
+        uint32_t hash;
+        // State::NO_NODE si el slot esta libre
+        uint32_t node;
+    };
+
+    CompactClosedSet();
+    ~CompactClosedSet();
+
+    // registra state si aun no tiene registro y lo marca cerrado. Los estados
+    // necesitan llave empaquetada (de un StatePool con StateEncoding)
+    bool insert(State *state);
+    bool contains(const State *state) const;
+    // la llave de state esta cerrada con el registro del mismo state, y no
+    // con el de otra copia
+    bool closedAs(const State *state) const;
+    // registro sin cerrarlo: en EPEA los hijos apuntan al padre antes de que
+    // este se cierre. Deja el indice en state->node
+    uint32_t record(State *state);
+    // lo saca del indice, el registro sigue porque puede ser padre de otros
+    void removeState(State *state);
+    void clear();
+    size_t reservedBytes() const;
+
+    // registros: llave, padre y movimiento del nodo i
+    unsigned int key_words;
+    uint64_t *keys;
+    uint32_t *parents;
+    uint16_t *moves;
+    size_t num_nodes;
+    size_t nodes_capacity;
+
+    // indice de los registros cerrados
+    Slot *slots;
+    size_t capacity;
+    size_t size;
+
+    static uint32_t hashOf(const State *state);
+    bool matches(uint32_t node, const State *state) const;
+    long long find(const State *state, uint32_t hash) const;
+    void placeSlot(uint32_t hash, uint32_t node);
+    void growNodes();
+    void growSlots();
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "MixedRadix.h"
+#include "Search.h"
+#include "SearchLimits.h"
+#include "StatePool.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// BFS sobre el espacio denso cuando el producto de (capacidad + 1) es chico:
+// cada estado es su indice MixedRadix, lo visitado es un bitmap y de cada
+// visitado se guarda el indice de su padre. Los hijos salen sumando y
+// restando strides al indice, sin HashTable ni un State por nodo; solo se
+// crean States para el camino. Como es BFS el camino es el mas corto. Se
+// guarda el padre y no el movimiento porque un trasvase no se puede deshacer
+// sin saber cuanto se paso.
+//
+// Va por capas: los hilos toman bloques de la capa actual, reclaman cada hijo
+// con fetch_or sobre su palabra del bitmap (uno solo gana y escribe el
+// padre) y lo dejan en su propio buffer; entre capas los buffers se juntan
+// al final de la cola. Capas chicas las expande solo el hilo principal
+class DenseSearch {
+    public:
+    // 2^24 estados: bitmap de 2 MB y 64 MB por cada arreglo de indices
+    static constexpr uint64_t DEFAULT_MAX_STATES = 1u << 24;
+    static constexpr uint32_t NO_RANK = 0xFFFFFFFFu;
+    // estados que toma un hilo de una vez
+    static constexpr size_t CHUNK_SIZE = 256;
+    // capa minima para repartirla entre hilos
+    static constexpr size_t PARALLEL_MIN_LEVEL = 8 * CHUNK_SIZE;
+
+    // hijos que encontro un hilo en la capa actual
+    struct Buffer {
+        uint32_t *ranks;
+        size_t count;
+        size_t capacity;
+    };
+
+    // num_threads = 0 usa todos los nucleos
+    DenseSearch(State *initial_state, State *target_state,
+                const unsigned int *capacities,
+                const SearchLimits &limits = SearchLimits(),
+                unsigned int num_threads = 0);
+    ~DenseSearch();
+
+    // el espacio cabe en max_states y en indices de 32 bits
+    static bool fits(const unsigned int *capacities, unsigned int size,
+                     uint64_t max_states);
+
+    // los estados del Path viven en el pool, son validos hasta destruir el
+    // DenseSearch
+    Search::Path findPath();
+
+    const unsigned int *capacities;
+    unsigned int size;
+    MixedRadix radix;
+    StatePool state_pool;
+    uint32_t start_rank;
+    // NO_RANK si el objetivo se sale de las capacidades
+    uint32_t goal_rank;
+    std::atomic<uint64_t> *visited;
+    uint64_t visited_words;
+    uint32_t *parents;
+    // cola del BFS: las capas una tras otra, en el orden en que se juntan
+    uint32_t *queue;
+    size_t queue_tail;
+    unsigned int num_threads;
+    Buffer *buffers;
+    // jarras de trabajo, size por hilo
+    unsigned int *worker_jugs;
+    size_t expanded;
+    // reservedBytes al empezar la capa: mientras corre, los buffers de los
+    // otros hilos no se pueden leer
+    size_t level_bytes;
+    LimitGovernor governor;
+
+    uint32_t rankOf(const unsigned int *values) const;
+    bool isVisited(uint64_t rank) const;
+    // expande queue[begin, end) y junta los hijos al final de la cola; true
+    // si se detuvo por el objetivo o por un tope
+    bool expandLevel(size_t begin, size_t end);
+    // lo que corre cada hilo. Solo el 0, que es el principal, mira los topes:
+    // el LimitGovernor no se comparte
+    void expandChunks(unsigned int worker, size_t end,
+                      std::atomic<size_t> &next,
+                      std::atomic<size_t> &level_expanded,
+                      std::atomic<bool> &halt, bool concurrent);
+    // marca rank si nadie lo marco antes y lo deja en buffer; true si es el
+    // objetivo. Sin concurrent no hace falta la operacion atomica
+    bool claim(uint64_t rank, uint32_t parent, Buffer &buffer,
+               bool concurrent);
+    Search::Path buildPath();
+    size_t reservedBytes() const;
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "BloomFilter.h"
+#include "Search.h"
+#include "SearchLimits.h"
+#include "StateEncoding.h"
+#include "StatePool.h"
+#include <cstdio>
+#include <string>
+
+// BFS en memoria externa con deteccion diferida de duplicados. Cada capa es
+// un archivo de llaves empaquetadas (StateEncoding) ordenadas y sin repetir.
+// Los hijos de la capa d se juntan en un buffer en RAM que, al llenarse, se
+// ordena y se escribe como corrida; al terminar la capa las corridas se
+// mezclan y cada llave se busca en las capas anteriores (los movimientos no
+// son reversibles, asi que pueden ser todas). Un filtro de Bloom con todas
+// las llaves ya escritas evita leer disco para las que seguro son nuevas, y
+// de cada capa queda en RAM la primera llave de cada bloque para leer solo el
+// bloque que podria tenerla. Como los pasos cuestan 1 el camino es el mas
+// corto, el mismo largo del A* optimo; se rehace hacia atras buscando en la
+// capa anterior algun predecesor del estado
+class ExternalSearch {
+    public:
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 256u << 20;
+    static constexpr const char *DEFAULT_WORK_DIR = "external_tmp";
+    // llaves por bloque de lectura
+    static constexpr size_t BLOCK_KEYS = 4096;
+    // 1 / BLOOM_SHARE del presupuesto va al filtro, el resto a las corridas
+    static constexpr unsigned int BLOOM_SHARE = 4;
+    static constexpr size_t NO_BLOCK = ~static_cast<size_t>(0);
+
+    // lectura por bloques de un archivo de llaves: secuencial con
+    // peek/advance, o saltando al bloque de una llave con loadBlock
+    struct Reader {
+        FILE *file;
+        uint64_t *buffer;
+        size_t count;
+        size_t pos;
+        size_t block;
+    };
+
+    // una capa en disco: sus llaves, la primera de cada bloque y su lector
+    struct Layer {
+        size_t size;
+        uint64_t *fences;
+        size_t num_fences;
+        size_t fences_capacity;
+        Reader reader;
+    };
+
+    ExternalSearch(State *initial_state, State *target_state,
+                   const unsigned int *capacities,
+                   size_t memory_budget = DEFAULT_MEMORY_BUDGET,
+                   const std::string &work_dir = DEFAULT_WORK_DIR,
+                   const SearchLimits &limits = SearchLimits());
+    // borra los archivos de las capas y corridas
+    ~ExternalSearch();
+
+    // los estados del Path viven en el pool, son validos hasta destruir el
+    // ExternalSearch
+    Search::Path findPath();
+
+    const unsigned int *capacities;
+    State *target_state;
+    StateEncoding encoding;
+    StatePool state_pool;
+    State *start_state;
+    // estado de trabajo: se le cargan las jarras de cada llave que se expande
+    State *cursor;
+    unsigned int size;
+    unsigned int key_words;
+    std::string work_dir;
+    std::string file_prefix;
+    uint64_t *goal_key;
+
+    BloomFilter seen;
+    Layer *layers;
+    unsigned int num_layers;
+    unsigned int layers_capacity;
+
+    // buffer de hijos y el orden en que se escriben
+    uint64_t *run_keys;
+    uint32_t *run_order;
+    size_t run_capacity;
+    size_t run_size;
+    unsigned int num_runs;
+
+    size_t expanded;
+    size_t stored;
+    // llaves que el filtro descarto sin leer disco, las que se buscaron en
+    // las capas y los bloques leidos para eso
+    size_t bloom_skips;
+    size_t disk_probes;
+    size_t block_reads;
+    // fallo al abrir, leer o escribir algun archivo
+    bool io_error;
+    LimitGovernor governor;
+
+    static int compareKeys(const uint64_t *a, const uint64_t *b,
+                           unsigned int words);
+    static uint64_t keyHash(const uint64_t *key, unsigned int words);
+    std::string layerPath(unsigned int layer) const;
+    std::string runPath(unsigned int run) const;
+
+    bool openReader(Reader &reader, const std::string &path);
+    bool loadBlock(Reader &reader, size_t block);
+    const uint64_t *peek(Reader &reader);
+    void advance(Reader &reader);
+    void closeReader(Reader &reader);
+
+    // indice de la capa nueva, el arreglo puede moverse al crecer
+    unsigned int addLayer();
+    void addFence(Layer &layer, const uint64_t *key);
+    // las tres devuelven false si se paso un tope o fallo un archivo
+    // expande la capa y deja sus hijos en corridas
+    bool expandLayer(unsigned int layer);
+    // ordena el buffer de hijos y lo escribe sin repetidos como corrida
+    bool flushRun();
+    // mezcla las corridas en una capa nueva sin las llaves ya vistas; found
+    // queda en true si aparece el objetivo, y ahi se deja de escribir
+    bool mergeRuns(bool &found);
+    bool inLayer(unsigned int layer, const uint64_t *key);
+    Search::Path buildPath(unsigned int goal_layer);
+    void removeFiles();
+    size_t reservedBytes() const;
+};
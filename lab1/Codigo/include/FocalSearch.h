@@ -0,0 +1,66 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "HashTable.h"
+#include "Heap.h"
+#include "PatternDatabase.h"
+#include "Search.h"
+#include "SearchLimits.h"
+#include "StateEncoding.h"
+#include "StatePool.h"
+
+// Focal search (A*eps). OPEN son buckets por f = g + cota admisible, y FOCAL
+// un PairingHeap por el peso de calculateHeuristic con los estados de OPEN
+// que tienen f <= w * f_min. Se expande siempre desde FOCAL, asi que el
+// camino que sale mide a lo mas w veces el optimo; f_min al sacar el objetivo
+// queda en el Path como cota inferior probada. Un estado cerrado que aparece
+// con menor g se reabre
+class FocalSearch {
+    public:
+    // estados de OPEN con un mismo f. Las entradas que ya salieron de OPEN
+    // quedan hasta la siguiente pasada por el bucket; live cuenta las validas
+    struct FBucket {
+        State **items;
+        size_t count;
+        size_t capacity;
+        size_t live;
+    };
+
+    FocalSearch(State *initial_state, State *target_state,
+                const unsigned int *capacities,
+                const Search::Options &options = Search::Options());
+    ~FocalSearch();
+
+    // los estados del Path viven en el pool, son validos hasta destruir el
+    // FocalSearch
+    Search::Path findPath();
+
+    const unsigned int *capacities;
+    State *target_state;
+    float suboptimality;
+    SearchLimits limits;
+    StateEncoding encoding;
+    ZobristHash zobrist;
+    StatePool state_pool;
+    PatternDatabase *pdb;
+    State *start_state;
+    // estado -> copia en OPEN; el handle de FOCAL va en State::open_handle
+    HashTable open_index;
+    HashTable closed_list;
+    PairingHeap focal;
+    FBucket *buckets;
+    unsigned int num_buckets;
+    unsigned int f_min;
+    unsigned int focal_bound;
+    size_t expanded;
+    size_t reopened;
+
+    static unsigned int f(const State *state);
+    void evaluate(State *state);
+    bool inOpen(State *state) const;
+    void pushOpen(State *state);
+    void removeOpen(State *state);
+    void refreshFocal();
+    unsigned int boundFor(unsigned int f_value) const;
+    size_t reservedBytes() const;
+    Search::Path reconstructPath(State *goal, unsigned int lower_bound) const;
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "HashTable.h"
+#include "Heap.h"
+#include "Search.h"
+#include "SearchLimits.h"
+#include "StateEncoding.h"
+#include "StatePool.h"
+#include "ZobristHash.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// A* paralelo distribuido por hash (HDA*): cada estado tiene un dueno segun
+// su hash de Zobrist, y solo el dueno lo guarda en su tabla, lo encola en su
+// pairing heap y lo expande. Cada hilo tiene su pool, su heap y su tabla, asi
+// que nada de eso lleva lock. Los hijos de otro dueno se juntan en lotes que
+// se le empujan a su bandeja, una pila sin lock de muchos productores que el
+// dueno vacia de una vez. La cota es movesLowerBound, igual que el A* optimo.
+//
+// Una meta sacada del heap solo mejora la solucion actual (con mutex); se
+// sigue hasta que el detector de terminacion confirma que no queda trabajo:
+// work cuenta los hilos activos mas los lotes en camino, y solo llega a 0
+// cuando todos estan ociosos y no hay lotes sin procesar. Los estados con
+// f >= la solucion actual se descartan, asi que al terminar es optima
+class HDAStarSearch {
+    public:
+    // hijos por lote
+    static constexpr unsigned int BATCH_SIZE = 64;
+    // expansiones entre envios de los lotes a medio llenar
+    static constexpr unsigned int FLUSH_INTERVAL = 32;
+    static constexpr unsigned int NO_SOLUTION = ~0u;
+
+    // hijos para un mismo dueno: padre, g, hash y jarras de cada uno
+    struct Batch {
+        Batch *next;
+        unsigned int count;
+        State *parents[BATCH_SIZE];
+        unsigned int depths[BATCH_SIZE];
+        uint64_t hashes[BATCH_SIZE];
+        unsigned int *jugs;
+
+        Batch(unsigned int jug_count);
+        ~Batch();
+    };
+
+    // lo de cada hilo: solo lo toca su dueno, menos la bandeja
+    struct Worker {
+        StatePool *state_pool;
+        PairingHeap open;
+        // la mejor copia de cada estado de este dueno, abierta o cerrada
+        HashTable seen;
+        std::atomic<Batch *> inbox;
+        // un lote en armado por destino
+        Batch **outgoing;
+        State::Move *moves;
+        unsigned int *child_jugs;
+        size_t expanded;
+        // estados guardados en seen
+        size_t stored;
+        size_t batches_sent;
+    };
+
+    // num_threads = 0 usa todos los nucleos
+    HDAStarSearch(State *initial_state, State *target_state,
+                  const unsigned int *capacities, unsigned int num_threads = 0,
+                  const SearchLimits &limits = SearchLimits());
+    ~HDAStarSearch();
+
+    // los estados del Path viven en los pools de los hilos, son validos hasta
+    // destruir el HDAStarSearch
+    Search::Path findPath();
+
+    const unsigned int *capacities;
+    State *target_state;
+    unsigned int size;
+    StateEncoding encoding;
+    ZobristHash zobrist;
+    unsigned int num_threads;
+    Worker *workers;
+    uint64_t start_hash;
+    unsigned int *start_jugs;
+
+    // hilos activos mas lotes en camino
+    std::atomic<long> work;
+    std::atomic<bool> stop;
+    // sumas de los contadores de cada hilo, se publican cada FLUSH_INTERVAL
+    // expansiones para los topes
+    std::atomic<size_t> total_expanded;
+    std::atomic<size_t> total_stored;
+    // registro en el pool, nodo del heap y slot en la tabla de un estado
+    size_t entry_bytes;
+    // el largo se lee sin lock para podar; el estado y el largo se cambian
+    // juntos con incumbent_mutex
+    std::atomic<unsigned int> incumbent_cost;
+    State *incumbent;
+    std::mutex incumbent_mutex;
+    // solo lo usa el hilo 0
+    LimitGovernor governor;
+
+    unsigned int ownerOf(uint64_t hash) const;
+    void run(unsigned int id);
+    // guarda el estado en el dueno id si mejora lo que ya tenia
+    void receive(unsigned int id, const unsigned int *jugs,
+                 unsigned int depth, uint64_t hash, State *parent);
+    // procesa los lotes de la bandeja, devuelve cuantos eran
+    long drainInbox(unsigned int id);
+    void expand(unsigned int id, State *state);
+    void send(unsigned int from, unsigned int to);
+    void flushAll(unsigned int id);
+    void offerSolution(State *goal);
+    // f mas chico de lo que no se expandio (heaps y bandejas), tras el join
+    unsigned int pendingBound();
+    void discardBatches(unsigned int id);
+    unsigned int weightOf(unsigned int f, unsigned int g) const;
+    Search::Path buildPath() const;
+};
@@ -1,34 +1,79 @@
 #pragma once
 #include "State.h"
+#include "ZobristHash.h"
+#include <cstddef>
 
 class HashTable {
     public:
-    static constexpr unsigned int INITIAL_SIZE = 1u << 16;
+    static constexpr size_t INITIAL_SIZE = 1u << 16;
     static constexpr float MAX_LOAD_FACTOR = 0.7f;
-    static constexpr unsigned int PRIME1 = 0x7FEB352D;
-    static constexpr unsigned int PRIME2 = 0x846CA68B;
-    static constexpr unsigned int PRIME3 = 0x4B1BD1B5;
+    static constexpr unsigned int MAX_PSL = 8;
+    static constexpr unsigned int MIGRATE_STEP = 64;
 
+    // politica de capacidad y sondeo, por defecto las constantes de arriba
+    struct Config {
+        size_t initial_capacity;
+        float max_load_factor;
+        // un sondeo mas largo que esto adelanta el crecimiento, pero solo si
+        // la tabla ya esta al menos a la mitad de max_load_factor
+        unsigned int max_psl;
+        // buckets de la tabla vieja que se migran por operacion
+        unsigned int migrate_step;
+
+        Config();
+    };
+
+    // metadata densa del bucket (8 bytes): 40 bits del hash hacen de huella y
+    // solo si coincide se mira el State, que vive en el arreglo states. Con
+    // esos 40 bits se recalcula la posicion al migrar, sin tocar el State
     struct Bucket {
-        State *state;
-        unsigned int psl;
+        unsigned int hash;
+        unsigned short psl;
+        unsigned char hash_high;
         bool occupied;
         Bucket();
     };
 
-    HashTable();
+    struct Table {
+        Bucket *buckets;
+        State **states;
+        size_t capacity;
+        size_t size;
+
+        Table();
+        void allocate(size_t capacity);
+        void release();
+    };
+
+    HashTable(const Config &config = Config());
     ~HashTable();
 
     bool insert(State *state);
     bool contains(const State *state) const;
+    State *lookup(const State *state) const;
+    bool replace(State *state);
     void cleanup();
+    void clear();
     void removeState(State *state);
+    bool migrating() const;
+    // memoria de las dos tablas, sin contar los estados
+    size_t reservedBytes() const;
 
-    Bucket *buckets;
-    unsigned int size;
-    unsigned int capacity;
+    Config config;
+    // table es donde se inserta; mientras se crece, old_table tiene lo que
+    // falta migrar y ambas son validas para las busquedas
+    Table table;
+    Table old_table;
+    size_t migrate_pos;
+    size_t size;
 
-    unsigned int computeHash(const State *state) const;
+    static uint64_t computeHash(const State *state);
+    static uint64_t storedHash(const Bucket &bucket);
     bool shouldResize() const;
-    void resize();
+    void startResize();
+    void migrateStep(size_t max_buckets);
+    void finishResize();
+    void insertHashed(State *state, uint64_t hash);
+    static long long find(const Table &t, const State *state, uint64_t hash);
+    static void eraseAt(Table &t, size_t pos);
 };
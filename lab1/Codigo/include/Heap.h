@@ -2,32 +2,54 @@
 #include "../include/TracyMacros.h"
 #include "State.h"
 
+// Pairing heap por peso. Los nodos salen de slabs propios del heap (no hay un
+// new por push) y push devuelve el nodo como handle para poder bajarle la
+// prioridad o sacarlo despues. Un handle deja de ser valido cuando su nodo
+// sale del heap
 class PairingHeap {
     public:
+    // leftChild es el primer hijo; prev apunta al hermano de la izquierda, o
+    // al padre si el nodo es el primer hijo
     struct Node {
         State *state;
+        unsigned int key;
         Node *leftChild;
         Node *nextSibling;
         Node *prev;
         Node(State *s);
     };
+    typedef Node *Handle;
 
-    static constexpr int INITIAL_CAPACITY = 4096;
+    static constexpr unsigned int NODES_PER_SLAB = 4096;
+    static constexpr unsigned int INITIAL_SLABS = 16;
 
     PairingHeap();
     ~PairingHeap();
 
-    void push(State *state);
+    Handle push(State *state);
     State *pop();
     State *peek() const;
+    void decreaseKey(Handle node, unsigned int key);
+    void erase(Handle node);
     void clear();
     bool empty() const;
+    size_t reservedBytes() const;
 
     Node *root;
     int size;
+    // slabs se conservan entre clear() para la siguiente busqueda
+    Node **slabs;
+    unsigned int num_slabs;
+    unsigned int slabs_capacity;
+    unsigned int slabs_in_use;
+    unsigned int used_in_slab;
+    Node *free_nodes;
 
     Node *merge(Node *h1, Node *h2);
     Node *mergePairs(Node *firstSibling);
-    void deleteTree(Node *node);
-    static bool hasHigherPriority(const State *a, const State *b);
+    void detach(Node *node);
+    Node *allocateNode(State *state);
+    void releaseNode(Node *node);
+    void addSlab();
+    static bool hasHigherPriority(const Node *a, const Node *b);
 };
@@ -0,0 +1,61 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "HeuristicFormula.h"
+#include "State.h"
+
+// Lo que calculateHeuristic saca del objetivo (el maximo por segmento) se
+// calcula una vez por busqueda, y de un estado que se expande se guardan sus
+// componentes: jarras correctas, correctas por segmento, suma del patron y
+// suma de transferencias por segmento. Un movimiento cambia a lo mas dos
+// jarras, asi que el peso de cada hijo sale de los componentes del padre
+// rehaciendo solo los segmentos que toca. Las piezas de la formula son las de
+// HeuristicFormula, las mismas de calculateHeuristic, asi que el peso es
+// exactamente el mismo
+class HeuristicContext {
+    public:
+    static constexpr unsigned int SEGMENT_SIZE =
+        HeuristicFormula::SEGMENT_SIZE;
+    // las jarras correctas del hijo estan entre las del padre -2 y +2
+    static constexpr int MAX_MATCH_DELTA = 2;
+    static constexpr unsigned int NUM_DELTAS = 2 * MAX_MATCH_DELTA + 1;
+
+    HeuristicContext(const State &target_state,
+                     const unsigned int *capacities);
+    ~HeuristicContext();
+
+    // el peso de calculateHeuristic, sin reservar memoria
+    unsigned int weightOf(const State &state);
+    // guarda los componentes de parent para pesar a sus hijos
+    void load(const State &parent);
+    // peso del hijo del ultimo estado cargado por move
+    unsigned int childWeight(const State::Move &move);
+
+    const unsigned int *capacities;
+    const unsigned int *target;
+    unsigned int size;
+    unsigned int num_segments;
+    unsigned int *segment_max;
+    unsigned int *segment_length;
+
+    // componentes del padre cargado. jugs es una copia de sus jarras donde
+    // se aplica cada movimiento y se deshace
+    const State *parent;
+    unsigned int *jugs;
+    unsigned int *segment_matches;
+    unsigned int matching;
+    unsigned int pattern_value;
+    float weights[3];
+    float pattern_boost;
+    // suma de transferencias del segmento s si el hijo tiene d - 2 jarras
+    // correctas mas que el padre: segment_transfer[s * NUM_DELTAS + d]
+    unsigned int *segment_transfer;
+    unsigned int total_transfer[NUM_DELTAS];
+    // contadores para weightOf, no pisan los del padre
+    unsigned int *scratch_matches;
+
+    unsigned int segmentOf(unsigned int i) const;
+    unsigned int segmentTransfer(unsigned int segment,
+                                 const unsigned int *values,
+                                 unsigned int matches,
+                                 float global_momentum) const;
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "State.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// Piezas de la heuristica de calculateHeuristic, compartidas con
+// HeuristicContext para que el peso completo y el incremental usen la misma
+// formula
+class HeuristicFormula {
+    public:
+    static constexpr unsigned int SEGMENT_SIZE = 8;
+
+    // calculo de pesos, transiciones lineales, mediano es constante, siempre
+    // queremos balancear. Despues se ajustan por la performance del algoritmo
+    static inline void strategyWeights(unsigned int depth, unsigned int size,
+                                       float *weights) {
+        float depth_ratio =
+            std::min(1.0f, static_cast<float>(depth) / 60.0f);
+
+        // Exploracion:
+        weights[0] = std::max(0.25f, 0.6f * (1.0f - depth_ratio));
+
+        // Balance: constante, siempre queremos algo de balance
+        weights[1] = 0.3f;
+
+        // Optimizacion: crece linealmente
+        weights[2] = std::min(0.6f, 0.2f + (depth_ratio * 0.4f));
+
+        // Normalizar pesos
+        normalize(weights);
+
+        // Ponderaror en base a size del problema
+        float size_factor = std::min(1.0f, static_cast<float>(size) / 30.0f);
+
+        if (State::adaptive_params.consecutive_improvements > 3) {
+            // Aumentar optimizaciom
+            float adjustment = 0.1f * size_factor;
+            weights[2] += adjustment;
+            weights[1] -= adjustment * 0.5f;
+            weights[0] -= adjustment * 0.5f;
+        } else if (State::adaptive_params.plateaus > 2) {
+            // Aumentar exploracion
+            float adjustment = 0.1f * size_factor;
+            weights[0] += adjustment;
+            weights[1] -= adjustment * 0.5f;
+            weights[2] -= adjustment * 0.5f;
+        }
+
+        // Asegurar almenos un peso
+        weights[0] = std::max(0.2f, weights[0]);
+        weights[1] = std::max(0.2f, weights[1]);
+        weights[2] = std::max(0.2f, weights[2]);
+        // ponderacion
+        normalize(weights);
+    }
+
+    static inline void normalize(float *weights) {
+        float sum = weights[0] + weights[1] + weights[2];
+        for (int i = 0; i < 3; i++) {
+            weights[i] /= sum;
+        }
+    }
+
+    static inline float patternBoost(const float *weights) {
+        return weights[0] * 30.0f + // Exploracion
+               weights[1] * 25.0f + // Balance
+               weights[2] * 20.0f;  // Optimizacion
+    }
+
+    // mayor prioridad a las que estan a la izquierda, los ejemplos todos
+    // funcionan en ese orden, si se cambia esto no sirve
+    static inline unsigned int patternTerm(float pattern_boost, unsigned int i,
+                                           unsigned int size) {
+        float position_factor = 1.0f - (static_cast<float>(i) / size);
+        return static_cast<unsigned int>(pattern_boost *
+                                         (1.0f + position_factor * 0.5f));
+    }
+
+    static inline float globalMomentum(unsigned int matching,
+                                       unsigned int size) {
+        return 1.0f - (static_cast<float>(matching) / size);
+    }
+
+    // factor de la heuristica, para cada una de las 3 estrategias
+    // considerando el momentum, se prefiere la expacion para los transfers
+    static inline float transferFactor(const float *weights,
+                                       float global_momentum,
+                                       unsigned int segment_matches,
+                                       unsigned int segment_length) {
+        float segment_momentum =
+            1.0f - (static_cast<float>(segment_matches) / segment_length);
+        float combined_momentum =
+            (global_momentum * 0.7f + segment_momentum * 0.3f);
+        return weights[0] *
+                   (10.0f - (5.0f * combined_momentum)) + // Exploracion
+               weights[1] *
+                   (20.0f - (10.0f * combined_momentum)) + // Balance
+               weights[2] *
+                   (30.0f - (15.0f * combined_momentum)); // Optimizacion
+    }
+
+    // operaciones para llegar al objetivo con el maximo del segmento
+    static inline unsigned int transferTerm(unsigned int value,
+                                            unsigned int target,
+                                            unsigned int local_max,
+                                            float transfer_factor) {
+        int diff = static_cast<int>(target) - static_cast<int>(value);
+        unsigned int operations = static_cast<unsigned int>(
+            std::ceil(static_cast<float>(std::abs(diff)) / local_max));
+        return static_cast<unsigned int>(operations * transfer_factor);
+    }
+
+    // Penalizar por profundidad
+    static inline float depthPenalty(unsigned int depth,
+                                     float global_momentum,
+                                     unsigned int size) {
+        return std::min(
+            0.1f + (depth / (size * 3.0f)) * (0.8f + global_momentum), 0.3f);
+    }
+
+    // Peso final, ponderado cada heuristica considerando el momentum y la
+    // profundidad transfers pq pierde precision al final y no se prefiere
+    static inline unsigned int combine(unsigned int transfer_value,
+                                       unsigned int pattern_value,
+                                       unsigned int depth,
+                                       unsigned int matching,
+                                       unsigned int size) {
+        float global_momentum = globalMomentum(matching, size);
+
+        // Normalizado por un maximo
+        unsigned int pattern_max = static_cast<unsigned int>(size * 25);
+        pattern_value =
+            pattern_max > pattern_value ? pattern_max - pattern_value : 0;
+
+        float depth_penalty = depthPenalty(depth, global_momentum, size);
+        return static_cast<unsigned int>(
+            transfer_value * (1.5f + global_momentum) +
+            pattern_value * (1.0f - depth_penalty) +
+            depth * depth_penalty * (10.0f + 20.0f * global_momentum));
+    }
+};
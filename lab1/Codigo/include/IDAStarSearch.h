@@ -0,0 +1,61 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "HashTable.h"
+#include "Search.h"
+#include "SearchLimits.h"
+#include "StateEncoding.h"
+#include "StatePool.h"
+
+// IDA* con pila explicita y tabla de transposicion acotada por memoria. El
+// umbral es sobre g + movesLowerBound, y los hijos se visitan ordenados por
+// el peso de calculateHeuristic. Solo viven los estados del camino actual, sus
+// hermanos pendientes y la tabla, que deja de crecer al llegar al presupuesto
+class IDAStarSearch {
+    public:
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 256u << 20;
+
+    // un nivel de la pila: el estado y sus hijos aun no visitados
+    struct Frame {
+        State *state;
+        State **children;
+        unsigned int num_children;
+        unsigned int next_child;
+    };
+
+    IDAStarSearch(State *initial_state, State *target_state,
+                  const unsigned int *capacities,
+                  size_t memory_budget = DEFAULT_MEMORY_BUDGET,
+                  const SearchLimits &limits = SearchLimits());
+    ~IDAStarSearch();
+
+    // los estados del Path viven en el pool, son validos hasta destruir el
+    // IDAStarSearch
+    Search::Path findPath();
+
+    const unsigned int *capacities;
+    State *target_state;
+    StateEncoding encoding;
+    ZobristHash zobrist;
+    StatePool state_pool;
+    State *start_state;
+    // copias propias en el pool: depth es el menor g con que se llego al
+    // estado y weight la iteracion en que se vio con ese g
+    HashTable transpositions;
+    size_t max_transpositions;
+    Frame *stack;
+    unsigned int stack_capacity;
+    unsigned int stack_size;
+    size_t expanded;
+    LimitGovernor governor;
+
+    static constexpr unsigned int NO_BOUND = ~0u;
+
+    bool isGoal(const State *state) const;
+    unsigned int depthFirst(unsigned int threshold, unsigned int iteration);
+    bool pruneByTable(State *child, unsigned int iteration);
+    void pushFrame(State *state);
+    void popFrame();
+    void sortChildren(State **children, unsigned int num_children) const;
+    Search::Path buildPath() const;
+    size_t reservedBytes() const;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include <cstddef>
+#include <cstdint>
+
+// Indice denso de un vector de jarras: cada posicion i es un digito en base
+// capacities[i] + 1, la primera es la menos significativa. Sirve para guardar
+// algo por estado en un arreglo plano cuando el espacio es chico
+class MixedRadix {
+    public:
+    MixedRadix();
+    MixedRadix(const unsigned int *capacities, unsigned int size);
+    MixedRadix(const MixedRadix &other);
+    MixedRadix &operator=(const MixedRadix &other);
+    ~MixedRadix();
+
+    uint64_t index(const unsigned int *values) const;
+    void decode(uint64_t index, unsigned int *values) const;
+    // tamano del espacio, o 0 si no cabe en 64 bits
+    static uint64_t spaceSize(const unsigned int *capacities,
+                              unsigned int size);
+
+    unsigned int size;
+    unsigned int *radix;
+    uint64_t *stride;
+    uint64_t total;
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "BucketQueue.h"
+#include "Heap.h"
+#include "State.h"
+
+enum class OpenListBackend { PAIRING_HEAP, BUCKET_QUEUE };
+
+// Fachada de la open list, igual que ClosedSet solo se reserva el backend
+// elegido y los metodos son inline porque se llaman por cada sucesor
+class OpenList {
+    public:
+    OpenList(OpenListBackend backend = OpenListBackend::PAIRING_HEAP,
+             BucketQueue::TieBreak tie_break = BucketQueue::TieBreak::LIFO);
+    ~OpenList();
+
+    static const char *backendName(OpenListBackend backend);
+
+    // devuelve el handle del nodo, nullptr con la bucket queue
+    inline void *push(State *state) {
+        if (heap) {
+            return heap->push(state);
+        }
+        buckets->push(state);
+        return nullptr;
+    }
+    // la copia encolada en handle pasa a ser better, con su peso
+    inline void replace(void *handle, State *better) {
+        PairingHeap::Handle node = static_cast<PairingHeap::Handle>(handle);
+        node->state = better;
+        heap->decreaseKey(node, better->weight);
+    }
+    inline State *pop() { return heap ? heap->pop() : buckets->pop(); }
+    inline State *peek() const {
+        return heap ? heap->peek() : buckets->peek();
+    }
+    inline bool empty() const {
+        return heap ? heap->empty() : buckets->empty();
+    }
+    inline void clear() {
+        if (heap) {
+            heap->clear();
+        } else {
+            buckets->clear();
+        }
+    }
+    inline size_t size() const {
+        return heap ? static_cast<size_t>(heap->size) : buckets->size;
+    }
+    inline size_t reservedBytes() const {
+        return heap ? heap->reservedBytes() : buckets->reservedBytes();
+    }
+
+    OpenListBackend backend;
+    PairingHeap *heap;
+    BucketQueue *buckets;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "MixedRadix.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Pattern databases para la cota del modo optimo. Las jarras se reparten en
+// grupos disjuntos (patrones) de a lo mas MAX_PATTERN_ENTRIES estados, y para
+// cada grupo se guarda la distancia exacta al objetivo en el problema
+// abstracto: un trasvase con una jarra de afuera puede mover una del patron
+// hasta la mayor capacidad de afuera, ademas de llenar, vaciar y los
+// trasvases dentro del patron. La cota es el maximo entre patrones.
+//
+// Las tablas se guardan en cache_dir y en la siguiente corrida se mapean con
+// mmap sin reconstruir. La distancia depende del objetivo, asi que el archivo
+// se identifica por capacidades y objetivo
+class PatternDatabase {
+    public:
+    static constexpr uint64_t MAX_PATTERN_ENTRIES = 1u << 20;
+    static constexpr unsigned char UNREACHABLE = 255;
+    static constexpr uint32_t MAGIC = 0x31424450;
+    static constexpr uint32_t VERSION = 1;
+    static constexpr const char *DEFAULT_CACHE_DIR = "pdb_cache";
+
+    struct Pattern {
+        unsigned int *jugs;
+        unsigned int num_jugs;
+        MixedRadix radix;
+        // donde empiezan sus distancias dentro de table
+        uint64_t offset;
+        // mayor capacidad fuera del patron, 0 si no hay jarras afuera
+        unsigned int outside_capacity;
+    };
+
+    // cabecera del archivo, le siguen capacidades, objetivo y el numero de
+    // jarras de cada patron (uint32), y las tablas alineadas a 8
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t jug_count;
+        uint32_t num_patterns;
+        uint64_t table_bytes;
+    };
+
+    PatternDatabase(const unsigned int *capacities, const unsigned int *target,
+                    unsigned int size,
+                    const std::string &cache_dir = DEFAULT_CACHE_DIR);
+    ~PatternDatabase();
+
+    // cota admisible de movimientos, UNREACHABLE si algun patron no puede
+    // llegar a su objetivo
+    unsigned int lookup(const unsigned int *jugs) const;
+
+    unsigned int size;
+    unsigned int *capacities;
+    unsigned int *target;
+    Pattern *patterns;
+    unsigned int num_patterns;
+    uint64_t table_bytes;
+    // las distancias viven en el archivo mapeado o en memoria propia
+    unsigned char *table;
+    void *mapped;
+    size_t mapped_size;
+    bool loaded_from_cache;
+    std::string cache_path;
+
+    void partition();
+    void build();
+    void buildPattern(const Pattern &pattern, unsigned char *distances,
+                      uint32_t *queue) const;
+    bool load();
+    bool save() const;
+    size_t dataOffset() const;
+    static std::string cacheFileName(const unsigned int *capacities,
+                                     const unsigned int *target,
+                                     unsigned int size);
+};
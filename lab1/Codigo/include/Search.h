@@ -1,15 +1,80 @@
 #pragma once
 #include "../include/TracyMacros.h"
+#include "ClosedSet.h"
 #include "HashTable.h"
+#include "HeuristicContext.h"
 #include "Heap.h"
+#include "OpenList.h"
+#include "PatternDatabase.h"
+#include "SearchLimits.h"
+#include "StateEncoding.h"
+#include "StatePool.h"
 #include <iostream>
 #include <random>
 
+class DenseSearch;
+
+// motor que usa el Solver: la busqueda heuristica de Search, el BFS
+// bidireccional (optimo, pero solo para espacios chicos), IDA* con memoria
+// acotada, Search como A* optimo con la cota admisible, focal search con
+// largo a lo mas suboptimality veces el optimo o la busqueda anytime que
+// mejora la solucion hasta pasar un tope de options.limits, el BFS con las
+// capas en disco o el A* paralelo distribuido por hash. Si el espacio denso
+// es chico, Search usa DenseSearch
+enum class SearchMode {
+    HEURISTIC,
+    BIDIRECTIONAL,
+    IDA_STAR,
+    OPTIMAL,
+    FOCAL,
+    ANYTIME,
+    EXTERNAL,
+    HDA_STAR
+};
+
 class Search {
     public:
     struct Path {
         State **states;
         unsigned int length;
+        // cota inferior probada del optimo en movimientos, 0 si no se conoce
+        unsigned int lower_bound;
+        // si se corto por un tope, el camino es el mejor parcial (o vacio)
+        StopReason stop_reason;
+    };
+
+    // opciones de la busqueda, se eligen antes de construir el Search
+    struct Options {
+        SearchMode mode;
+        ClosedSetBackend closed_backend;
+        // capacidad y politica de sondeo del closed set Robin Hood
+        HashTable::Config table_config;
+        OpenListBackend open_backend;
+        // desempate dentro de un mismo peso en la bucket queue
+        BucketQueue::TieBreak tie_break;
+        // bytes para la tabla de transposicion de IDA*, o para el filtro de
+        // Bloom y las corridas de la busqueda en memoria externa
+        size_t memory_budget;
+        // en modo optimo, sumar la cota de las pattern databases
+        bool use_pdb;
+        std::string pdb_cache_dir;
+        // directorio de las capas de la busqueda en memoria externa
+        std::string external_dir;
+        // en modo optimo, expansion parcial (EPEA*)
+        bool partial_expansion;
+        // en modo heuristico, calcular la heuristica al sacar de open
+        bool deferred_evaluation;
+        // factor w de focal search
+        float suboptimality;
+        // topes de tiempo, expansiones y memoria de cualquier motor
+        SearchLimits limits;
+        // espacios de a lo mas tantos estados se resuelven con DenseSearch
+        // (BFS exacto) en vez de la busqueda con HashTable, 0 = nunca
+        uint64_t dense_max_states;
+        // hilos del BFS denso y de HDA*, 0 = todos los nucleos
+        unsigned int threads;
+
+        Options();
     };
 
     struct StagnationParams {
@@ -37,21 +102,94 @@ class Search {
                                   StagnationParams &stag);
     // Constructor y destructor
     Search(State *initial_state, State *target_state,
-           const unsigned int *capacities);
+           const unsigned int *capacities, const Options &options = Options());
     ~Search();
 
     // Funciones principales
+    // los estados del Path viven en el pool, son validos hasta destruir el
+    // Search
     Path findPath();
     static void freePath(Path &path);
     // Miembros de clase
     const unsigned int *capacities;
+    Options options;
     State *initial_state;
     State *target_state;
-    PairingHeap open_list;
-    HashTable closed_list;
+    StateEncoding encoding;
+    ZobristHash zobrist;
+    StatePool state_pool;
+    // copias en el pool de los estados inicial y objetivo, con llave
+    // empaquetada
+    State *start_state;
+    State *goal_state;
+    // solo en modo optimo con use_pdb
+    PatternDatabase *pdb;
+    // si el espacio cabe en options.dense_max_states findPath lo delega
+    DenseSearch *dense;
+    // tablas del objetivo y componentes del estado que se expande
+    HeuristicContext heuristic;
+    OpenList open_list;
+    // una entrada por configuracion encolada, apunta a la mejor copia
+    HashTable open_index;
+    ClosedSet closed_list;
+    // copias peores descartadas al generar
+    size_t open_duplicates;
+    // movimientos del estado que se expande y sus jarras y llave, donde se
+    // aplica cada movimiento. probe es el hijo sin materializar: un State
+    // fuera del pool que mira scratch_jugs y scratch_key, con el que se
+    // consultan closed y open
+    State::Move *moves;
+    unsigned int *scratch_jugs;
+    uint64_t *scratch_key;
+    State probe;
+    size_t partial_requeues;
+    // estados que al evaluarlos ya no eran los mejores de open
+    size_t deferred_requeues;
+    // el mas cercano al objetivo hasta ahora, es lo que se devuelve si se
+    // corta la busqueda
+    State *best_state;
     void cleanupOldStates(unsigned int current_depth);
     void cleanupSuccessors(State **successors, unsigned int num_successors);
-    Path reconstructPath(State *final_state, unsigned int total_states);
+    Path reconstructPath(State *final_state);
+    // con el closed set compacto: los estados del camino se rehacen
+    // repitiendo desde start_state los movimientos de los registros
+    State **replayPath(const State *final_state, unsigned int &length);
+    // bytes reservados por el pool, open y closed
+    size_t reservedBytes() const;
+    // en modo optimo el peso es f = g + h en los bits altos y, para desempatar
+    // a favor del g mas grande, el complemento de g en los 8 bajos. Con pocos
+    // bits la bucket queue sigue chica; un g mayor solo pierde el desempate
+    static constexpr unsigned int DEPTH_BITS = 8;
+    static constexpr unsigned int DEPTH_MASK = (1u << DEPTH_BITS) - 1;
+
+    bool optimal() const;
+    bool partialExpansion() const;
+    bool deferredEvaluation() const;
+    bool compactClosed() const;
+    // deja en child el enlace a parent: el puntero, o con el closed set
+    // compacto el registro del padre y el codigo de move
+    void linkChild(State *child, const State *parent,
+                   const State::Move &move) const;
+    // con el closed set compacto, un estado cerrado vuelve al pool (salvo el
+    // mejor hasta ahora): sus hijos solo miran su registro
+    void retire(State *state);
+    unsigned int expandPartially(State *current);
+    unsigned int distanceToGoal(const State *state) const;
+    void evaluate(State *state);
+    bool isDeadEnd(const State *state) const;
+    void pushOpen(State *state);
+    // encola state sabiendo que queued es la copia en open (o nullptr) y que
+    // state es mejor
+    void enqueue(State *state, State *queued);
+    // copia las jarras y la llave de parent a las de probe
+    void resetProbe(const State *parent);
+    // aplica move de parent sobre scratch_jugs y deja probe como ese hijo
+    void loadProbe(const State *parent, const State::Move &move);
+    void unloadProbe(const State *parent, const State::Move &move);
+    // pushOpen del hijo en probe, ya evaluado
+    void pushProbe();
+    State *popOpen();
+    static bool isBetterCopy(const State *candidate, const State *queued);
     void cleanUpStates();
     void cleanUpState(State *state);
     bool isSpecialState(State *state) const;
@@ -0,0 +1,48 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+// motivo por el que termino una busqueda: COMPLETED si termino sola (con o
+// sin solucion), si no el tope que se paso
+enum class StopReason {
+    COMPLETED,
+    TIME,
+    EXPANSIONS,
+    LIVE_STATES,
+    MEMORY,
+    CANCELLED
+};
+
+// topes de recursos de una busqueda, 0 es sin limite. cancel es una bandera
+// de afuera (otro hilo, una senal) que no es del SearchLimits
+struct SearchLimits {
+    unsigned int max_time_ms;
+    size_t max_expansions;
+    size_t max_live_states;
+    size_t max_bytes;
+    const std::atomic<bool> *cancel;
+
+    SearchLimits();
+};
+
+// Revisa los topes desde el ciclo principal de un motor. Los contadores se
+// comparan en cada llamada; el reloj y la bandera, que cuestan mas, cada
+// CLOCK_CHECK_INTERVAL llamadas. Una vez que se pasa un tope queda pasado
+class LimitGovernor {
+    public:
+    static constexpr unsigned int CLOCK_CHECK_INTERVAL = 256;
+
+    LimitGovernor(const SearchLimits &limits);
+
+    // true si se paso algun tope, el motivo queda en reason
+    bool exceeded(size_t expansions, size_t live_states, size_t bytes);
+    long long elapsedMs() const;
+    static const char *reasonName(StopReason reason);
+
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start_time;
+    unsigned int since_check;
+    StopReason reason;
+};
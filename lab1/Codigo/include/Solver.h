@@ -1,5 +1,11 @@
 #pragma once
 #include "../include/TracyMacros.h"
+#include "AnytimeSearch.h"
+#include "BidirectionalSearch.h"
+#include "ExternalSearch.h"
+#include "FocalSearch.h"
+#include "HDAStarSearch.h"
+#include "IDAStarSearch.h"
 #include "Search.h"
 #include "State.h"
 #include <chrono>
@@ -13,10 +19,14 @@ class Solver {
     void solve();
     bool isInitialized() const;
     void printCurrentStates() const;
+    void setSearchOptions(const Search::Options &options);
+    const Search::Options &getSearchOptions() const;
 
     private:
     State *max_state;
     State *target_state;
     bool initialized;
+    Search::Options search_options;
     void cleanup();
+    void printSolution(const Search::Path &solution, long long duration) const;
 };
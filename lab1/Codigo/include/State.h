@@ -1,20 +1,64 @@
 #pragma once
 #include "../include/TracyMacros.h"
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
 
+class StatePool;
+
 class State {
     public:
     State *parent;
     mutable bool heuristic_calculated;
     unsigned int size;
     unsigned int *jugs;
+    // falso cuando las jarras viven inline en un registro del StatePool
+    bool owns_jugs;
+    // ya genero hijos que lo apuntan como parent, no se puede liberar
+    bool expanded;
+    // llave empaquetada (StateEncoding), nullptr si el estado no viene de un
+    // pool con codificacion
+    uint64_t *key;
+    unsigned int key_words;
+    // hash de Zobrist puesto por un StatePool con ZobristHash; si hashed es
+    // falso HashTable lo calcula desde las jarras
+    uint64_t hash;
+    bool hashed;
     unsigned int depth;
     unsigned int weight;
+    // movesLowerBound guardado por la busqueda en modo optimo
+    unsigned int lower_bound;
+    // la PDB dio UNREACHABLE: desde aqui no se llega al objetivo. Va aparte
+    // de lower_bound, que con muchas jarras distintas puede pasar de 255
+    bool dead_end;
+    // handle del nodo en la open list mientras el estado esta encolado (solo
+    // con pairing heap), para mejorar su prioridad sin encolar otra copia
+    void *open_handle;
+    // con el closed set compacto: el registro de este estado (NO_NODE hasta
+    // que se registra), el del padre y el codigo del movimiento que lo genero
+    uint32_t node;
+    uint32_t parent_node;
+    uint16_t move_code;
+
+    // un movimiento sin construir el estado: llenar o vaciar from, o
+    // trasvasar from -> to
+    struct Move {
+        enum Type : unsigned char { FILL, EMPTY, POUR };
+        Type type;
+        unsigned int from;
+        unsigned int to;
+
+        // codigo de dos bytes: FILL i es i, EMPTY i es size + i y POUR i -> j
+        // es 2 * size + i * size + j. Alcanza hasta MAX_CODED_JUGS jarras
+        uint16_t code(unsigned int size) const;
+        static Move fromCode(uint16_t code, unsigned int size);
+    };
+    static constexpr unsigned int MAX_CODED_JUGS = 255;
+    static constexpr uint32_t NO_NODE = 0xFFFFFFFFu;
 
     struct AdaptiveParams {
         float exploration_weight;
@@ -38,8 +82,29 @@ class State {
 
     bool equals(const State *other) const;
     void calculateHeuristic(const State &target_state);
+    unsigned int movesLowerBound(const State &target_state) const;
+    unsigned int mismatchedJugs(const State &target_state) const;
+    // a lo mas size * (size + 1) movimientos, en el orden de
+    // generateSuccessors
+    unsigned int generateMoves(const unsigned int *capacities,
+                               Move *moves) const;
+    // escribe en new_jugs (una copia de jugs) las jarras que cambia move
+    void applyMove(const Move &move, const unsigned int *capacities,
+                   unsigned int *new_jugs) const;
+    // cambio en mismatchedJugs que produce move, sin aplicarlo
+    int mismatchDelta(const Move &move, const unsigned int *capacities,
+                      const State &target_state) const;
     State **generateSuccessors(const unsigned int *capacities,
-                               unsigned int &num_successors) const;
+                               unsigned int &num_successors,
+                               StatePool *pool = nullptr) const;
+    State **generatePredecessors(const unsigned int *capacities,
+                                 unsigned int &num_predecessors,
+                                 StatePool *pool = nullptr) const;
+    State *makeChild(const unsigned int *new_jugs, StatePool *pool) const;
+    // hijo que difiere de este estado solo en las jarras first y second
+    // (pueden ser la misma): su hash sale del de este estado
+    State *makeChild(const unsigned int *new_jugs, StatePool *pool,
+                     unsigned int first, unsigned int second) const;
     void printState(const char *label);
     static bool readStatesFromFile(const std::string &fileName,
                                    State *max_state, State *target_state);
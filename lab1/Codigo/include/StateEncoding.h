@@ -0,0 +1,27 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include <cstdint>
+
+// Codificacion compacta de un estado: cada jarra usa solo los bits que
+// necesita su capacidad y se empaquetan en palabras de 64 bits (una jarra
+// nunca queda partida entre dos palabras). Se calcula una vez por busqueda a
+// partir del vector de capacidades
+class StateEncoding {
+    public:
+    static constexpr unsigned int WORD_BITS = 64;
+
+    StateEncoding(const unsigned int *capacities, unsigned int size);
+    ~StateEncoding();
+
+    void pack(const unsigned int *jugs, uint64_t *key) const;
+    void unpack(const uint64_t *key, unsigned int *jugs) const;
+    // cambia en key solo el campo de la jarra jug
+    void set(uint64_t *key, unsigned int jug, unsigned int value) const;
+    static unsigned int bitsFor(unsigned int capacity);
+
+    unsigned int size;
+    unsigned int words;
+    unsigned int *bits;
+    unsigned int *shifts;
+    unsigned int *word_index;
+};
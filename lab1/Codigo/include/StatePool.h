@@ -0,0 +1,49 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "State.h"
+#include "StateEncoding.h"
+#include "ZobristHash.h"
+#include <cstddef>
+
+// Arena de estados para una busqueda: cada registro guarda el State y justo
+// despues su arreglo de jarras (y la llave empaquetada si se entrega una
+// codificacion), todo en bloques grandes (slabs). Con un ZobristHash cada
+// estado sale con su hash. Los estados
+// descartados vuelven a una free list y se reutilizan, y toda la memoria se
+// libera de una vez al destruir el pool (junto con el Search)
+class StatePool {
+    public:
+    static constexpr unsigned int STATES_PER_SLAB = 4096;
+    static constexpr unsigned int INITIAL_SLABS = 16;
+
+    StatePool(unsigned int jug_count,
+              const StateEncoding *encoding = nullptr,
+              const ZobristHash *zobrist = nullptr);
+    ~StatePool();
+
+    State *allocate(const unsigned int *jugs, unsigned int depth,
+                    unsigned int weight, State *parent);
+    // igual, con el hash ya calculado (del padre, con ZobristHash::update)
+    State *allocate(const unsigned int *jugs, unsigned int depth,
+                    unsigned int weight, State *parent, uint64_t hash);
+    void release(State *state);
+    void clear();
+    // memoria reservada en slabs, este o no en uso
+    size_t reservedBytes() const;
+
+    unsigned int jug_count;
+    const StateEncoding *encoding;
+    const ZobristHash *zobrist;
+    size_t key_offset;
+    size_t record_size;
+    char **slabs;
+    unsigned int num_slabs;
+    unsigned int slabs_capacity;
+    unsigned int used_in_slab;
+    State *free_list;
+    size_t live_states;
+
+    State *place(const unsigned int *jugs, unsigned int depth,
+                 unsigned int weight, State *parent);
+    void addSlab();
+};
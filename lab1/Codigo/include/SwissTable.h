@@ -0,0 +1,52 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include "HashTable.h"
+#include "State.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Closed set alternativo al Robin Hood de HashTable, estilo Swiss table: un
+// byte de control por slot con los 7 bits bajos del hash, y el sondeo compara
+// un grupo entero de bytes de control de una vez (32 con AVX2, 16 con SSE2).
+// Solo se mira el State cuando el tag coincide
+class SwissTable {
+    public:
+#ifdef __AVX2__
+    static constexpr unsigned int GROUP_SIZE = 32;
+#else
+    static constexpr unsigned int GROUP_SIZE = 16;
+#endif
+    static constexpr unsigned int INITIAL_SIZE = 1u << 16;
+    static constexpr unsigned int CACHE_LINE = 64;
+    static constexpr float MAX_LOAD_FACTOR = 0.875f;
+    static constexpr signed char EMPTY = -128;
+    static constexpr signed char DELETED = -2;
+
+    SwissTable();
+    ~SwissTable();
+
+    bool insert(State *state);
+    bool contains(const State *state) const;
+    void cleanup();
+    void clear();
+    void removeState(State *state);
+    size_t reservedBytes() const;
+
+    signed char *ctrl;
+    signed char *ctrl_storage;
+    State **states;
+    unsigned int size;
+    unsigned int tombstones;
+    unsigned int capacity;
+
+    static unsigned int matchMask(const signed char *group, signed char value);
+    static unsigned int freeMask(const signed char *group);
+    static unsigned int hashOf(const State *state);
+    void allocate();
+    void insertHashed(State *state, unsigned int hash);
+    long find(const State *state, unsigned int hash) const;
+    bool shouldResize() const;
+    void resize(unsigned int new_capacity);
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include "../include/TracyMacros.h"
+#include <cstddef>
+#include <cstdint>
+
+// Hash de Zobrist: cada par (jarra, valor) tiene una llave de 64 bits y el
+// hash de un estado es el xor de las llaves de sus jarras. Un hijo cambia una
+// o dos jarras, asi que su hash sale del del padre sacando y poniendo solo
+// esas llaves. Las llaves son una funcion fija del par, las tablas solo las
+// guardan para las capacidades de la busqueda: un estado sin hash guardado da
+// lo mismo calculado desde cero con computeFrom
+class ZobristHash {
+    public:
+    // con mas pares que esto (capacidades muy grandes) no se arman tablas y
+    // las llaves se calculan al vuelo
+    static constexpr size_t MAX_TABLE_ENTRIES = 1u << 20;
+
+    ZobristHash(const unsigned int *capacities, unsigned int size);
+    ~ZobristHash();
+
+    uint64_t key(unsigned int jug, unsigned int value) const;
+    uint64_t hashOf(const unsigned int *jugs) const;
+    // hash despues de cambiar la jarra jug de old_value a new_value
+    uint64_t update(uint64_t hash, unsigned int jug, unsigned int old_value,
+                    unsigned int new_value) const;
+    // hash de child_jugs, que difiere de parent_jugs solo en first y second
+    // (pueden ser la misma jarra)
+    uint64_t childHash(uint64_t parent_hash, const unsigned int *parent_jugs,
+                       const unsigned int *child_jugs, unsigned int first,
+                       unsigned int second) const;
+    static uint64_t mixKey(unsigned int jug, unsigned int value);
+    static uint64_t computeFrom(const unsigned int *jugs, unsigned int size);
+
+    unsigned int size;
+    // llave de (i, v) en keys[offsets[i] + v], nullptr si no hay tablas
+    uint64_t *keys;
+    size_t *offsets;
+};
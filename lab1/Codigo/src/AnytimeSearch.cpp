@@ -0,0 +1,227 @@
+#include "../include/AnytimeSearch.h"
+
+const float AnytimeSearch::WEIGHTS[] = {5.0f, 3.0f, 2.0f, 1.5f, 1.25f, 1.0f};
+const unsigned int AnytimeSearch::NUM_WEIGHTS =
+    sizeof(WEIGHTS) / sizeof(WEIGHTS[0]);
+
+AnytimeSearch::AnytimeSearch(State *initial_state, State *target_state,
+                             const unsigned int *capacities,
+                             const Search::Options &options)
+    : encoding(capacities, initial_state->size),
+      zobrist(capacities, initial_state->size),
+      state_pool(initial_state->size, &encoding, &zobrist),
+      incumbent_pool(initial_state->size, &encoding, &zobrist),
+      open_index(options.table_config), closed_list(options.table_config),
+      governor(options.limits) {
+    TRACE_SCOPE;
+    this->capacities = capacities;
+    this->initial_state = initial_state;
+    this->target_state = target_state;
+    this->options = options;
+    this->pdb = options.use_pdb
+                    ? new PatternDatabase(capacities, target_state->jugs,
+                                          target_state->size,
+                                          options.pdb_cache_dir)
+                    : nullptr;
+    this->incumbent = nullptr;
+    this->incumbent_length = NO_INCUMBENT;
+    this->proven_optimal = false;
+    this->expanded = 0;
+}
+
+AnytimeSearch::~AnytimeSearch() {
+    TRACE_SCOPE;
+    resetRound();
+    delete[] incumbent;
+    delete pdb;
+}
+
+void AnytimeSearch::setImprovementCallback(
+    const ImprovementCallback &callback) {
+    on_improvement = callback;
+}
+
+Search::Path AnytimeSearch::findPath() {
+    TRACE_SCOPE;
+    governor = LimitGovernor(options.limits);
+
+    // ronda 0 greedy (peso 0), luego los pesos de WEIGHTS
+    for (unsigned int round = 0; round <= NUM_WEIGHTS; round++) {
+        float weight = round == 0 ? 0.0f : WEIGHTS[round - 1];
+        RoundResult result = runRound(weight);
+        if (result == RoundResult::INTERRUPTED) {
+            break;
+        }
+        if (result == RoundResult::EXHAUSTED ||
+            (weight == 1.0f && result == RoundResult::IMPROVED)) {
+            proven_optimal = true;
+            break;
+        }
+    }
+    resetRound();
+
+    std::cout << "\nSearch statistics:" << std::endl;
+    std::cout << "Expanded states: " << expanded << std::endl;
+    if (incumbent) {
+        std::cout << (proven_optimal ? "Optimal" : "Best so far") << ": "
+                  << incumbent_length << " moves" << std::endl;
+    }
+    return incumbentPath();
+}
+
+// Una ronda de weighted A* con reapertura. Todo lo que tiene g + h mayor o
+// igual a la incumbente se poda, asi que agotar OPEN prueba que no hay un
+// camino mas corto. Con peso 0 el orden es el de calculateHeuristic
+AnytimeSearch::RoundResult AnytimeSearch::runRound(float weight) {
+    TRACE_SCOPE;
+    resetRound();
+    State *start = state_pool.allocate(initial_state->jugs, 0, 0, nullptr);
+    evaluate(start, weight);
+    if (start->dead_end) {
+        return RoundResult::EXHAUSTED;
+    }
+    start->open_handle = open_list.push(start);
+    open_index.insert(start);
+
+    while (!open_list.empty()) {
+        if (governor.exceeded(expanded,
+                              state_pool.live_states +
+                                  incumbent_pool.live_states,
+                              reservedBytes())) {
+            return RoundResult::INTERRUPTED;
+        }
+
+        State *current = open_list.pop();
+        current->open_handle = nullptr;
+        open_index.removeState(current);
+        if (current->depth + current->lower_bound >= incumbent_length) {
+            continue;
+        }
+        if (current->lower_bound == 0 &&
+            memcmp(current->jugs, target_state->jugs,
+                   current->size * sizeof(unsigned int)) == 0) {
+            publish(current, weight);
+            return RoundResult::IMPROVED;
+        }
+
+        closed_list.insert(current);
+        expanded++;
+
+        unsigned int num_successors = 0;
+        State **successors = current->generateSuccessors(
+            capacities, num_successors, &state_pool);
+        for (unsigned int i = 0; i < num_successors; i++) {
+            State *child = successors[i];
+            evaluate(child, weight);
+            if (child->depth + child->lower_bound >= incumbent_length) {
+                state_pool.release(child);
+                continue;
+            }
+
+            // un cerrado con peor g se reabre; no se libera, puede ser padre
+            State *closed = closed_list.lookup(child);
+            if (closed) {
+                if (closed->depth <= child->depth) {
+                    state_pool.release(child);
+                    continue;
+                }
+                closed_list.removeState(closed);
+            }
+
+            // la copia encolada se cambia en su nodo del heap
+            State *queued = open_index.lookup(child);
+            if (queued) {
+                if (queued->depth <= child->depth) {
+                    state_pool.release(child);
+                    continue;
+                }
+                PairingHeap::Handle node =
+                    static_cast<PairingHeap::Handle>(queued->open_handle);
+                node->state = child;
+                open_list.decreaseKey(node, child->weight);
+                child->open_handle = node;
+                open_index.replace(child);
+                state_pool.release(queued);
+                continue;
+            }
+            child->open_handle = open_list.push(child);
+            open_index.insert(child);
+        }
+        delete[] successors;
+    }
+    return RoundResult::EXHAUSTED;
+}
+
+// lower_bound es la cota admisible (con la PDB si hay) y weight la prioridad:
+// f_w = g + w * h escalado, con desempate por g mayor en los 8 bits bajos
+void AnytimeSearch::evaluate(State *state, float weight) {
+    state->lower_bound = state->movesLowerBound(*target_state);
+    if (pdb) {
+        unsigned int pattern_bound = pdb->lookup(state->jugs);
+        state->dead_end = pattern_bound == PatternDatabase::UNREACHABLE;
+        if (pattern_bound > state->lower_bound) {
+            state->lower_bound = pattern_bound;
+        }
+    }
+    if (weight == 0.0f) {
+        state->calculateHeuristic(*target_state);
+        return;
+    }
+    unsigned int scaled_weight =
+        static_cast<unsigned int>(weight * WEIGHT_SCALE + 0.5f);
+    unsigned int priority =
+        state->depth * WEIGHT_SCALE + scaled_weight * state->lower_bound;
+    unsigned int g = std::min(state->depth, 255u);
+    state->weight = (priority << 8) | (255u - g);
+}
+
+size_t AnytimeSearch::reservedBytes() const {
+    return state_pool.reservedBytes() + incumbent_pool.reservedBytes() +
+           open_list.reservedBytes() + open_index.reservedBytes() +
+           closed_list.reservedBytes();
+}
+
+// copia el camino a incumbent_pool, porque el pool de la ronda se vacia
+void AnytimeSearch::publish(State *goal, float weight) {
+    TRACE_SCOPE;
+    incumbent_pool.clear();
+    delete[] incumbent;
+    incumbent_length = goal->depth;
+    incumbent = new State *[incumbent_length + 1];
+    unsigned int index = incumbent_length + 1;
+    for (State *s = goal; s; s = s->parent) {
+        incumbent[--index] = s;
+    }
+    State *parent = nullptr;
+    for (unsigned int i = 0; i <= incumbent_length; i++) {
+        incumbent[i] = incumbent_pool.allocate(incumbent[i]->jugs, i, 0,
+                                               parent);
+        parent = incumbent[i];
+    }
+
+    // vista sin copiar: el arreglo sigue siendo de AnytimeSearch
+    if (on_improvement) {
+        Search::Path view = {incumbent, incumbent_length + 1, 0,
+                             StopReason::COMPLETED};
+        on_improvement(view, weight);
+    }
+}
+
+void AnytimeSearch::resetRound() {
+    open_list.clear();
+    open_index.clear();
+    closed_list.clear();
+    state_pool.clear();
+}
+
+// vista de la incumbente, el arreglo del Path es propio del que lo recibe
+Search::Path AnytimeSearch::incumbentPath() const {
+    if (!incumbent) {
+        return {nullptr, 0, 0, governor.reason};
+    }
+    unsigned int length = incumbent_length + 1;
+    State **path_states = new State *[length];
+    memcpy(path_states, incumbent, length * sizeof(State *));
+    return {path_states, length, proven_optimal ? incumbent_length : 0,
+            governor.reason};
+}
@@ -0,0 +1,179 @@
+#include "../include/BidirectionalSearch.h"
+
+BidirectionalSearch::Frontier::Frontier() {
+    this->states = nullptr;
+    this->count = 0;
+    this->capacity = 0;
+}
+
+BidirectionalSearch::Frontier::~Frontier() { delete[] states; }
+
+void BidirectionalSearch::Frontier::push(State *state) {
+    if (count == capacity) {
+        size_t new_capacity = capacity ? capacity * 2 : 1024;
+        State **bigger = new State *[new_capacity];
+        if (states) {
+            memcpy(bigger, states, count * sizeof(State *));
+        }
+        delete[] states;
+        states = bigger;
+        capacity = new_capacity;
+    }
+    states[count++] = state;
+}
+
+void BidirectionalSearch::Frontier::swap(Frontier &other) {
+    std::swap(states, other.states);
+    std::swap(count, other.count);
+    std::swap(capacity, other.capacity);
+}
+
+BidirectionalSearch::BidirectionalSearch(State *initial_state,
+                                         State *target_state,
+                                         const unsigned int *capacities,
+                                         size_t max_states,
+                                         const SearchLimits &limits)
+    : encoding(capacities, initial_state->size),
+      zobrist(capacities, initial_state->size),
+      state_pool(initial_state->size, &encoding, &zobrist),
+      governor(limits) {
+    TRACE_SCOPE;
+    this->capacities = capacities;
+    this->limits = limits;
+    if (limits.max_live_states == 0 || limits.max_live_states > max_states) {
+        this->limits.max_live_states = max_states;
+    }
+    this->start_state =
+        state_pool.allocate(initial_state->jugs, 0, 0, nullptr);
+    this->goal_state = state_pool.allocate(target_state->jugs, 0, 0, nullptr);
+    this->expanded = 0;
+}
+
+// el pool es dueno de todos los estados, las tablas solo se vacian
+BidirectionalSearch::~BidirectionalSearch() {
+    TRACE_SCOPE;
+    forward_seen.clear();
+    backward_seen.clear();
+}
+
+Search::Path BidirectionalSearch::findPath() {
+    TRACE_SCOPE;
+    if (start_state->equals(goal_state)) {
+        return reconstructPath(start_state, goal_state);
+    }
+
+    forward_seen.insert(start_state);
+    backward_seen.insert(goal_state);
+    forward_frontier.push(start_state);
+    backward_frontier.push(goal_state);
+
+    State *forward_meet = nullptr;
+    State *backward_meet = nullptr;
+    governor = LimitGovernor(limits);
+    while (forward_frontier.count > 0 && backward_frontier.count > 0) {
+        bool forward = forward_frontier.count <= backward_frontier.count;
+        if (!expandLayer(forward, forward_meet, backward_meet)) {
+            break;
+        }
+        if (forward_meet) {
+            break;
+        }
+    }
+
+    std::cout << "\nSearch statistics:" << std::endl;
+    std::cout << "Expanded states: " << expanded << std::endl;
+    std::cout << "Forward states: " << forward_seen.size
+              << ", backward states: " << backward_seen.size << std::endl;
+
+    // un encuentro de una capa cortada no es necesariamente el mas corto
+    if (!forward_meet || governor.reason != StopReason::COMPLETED) {
+        return {nullptr, 0, 0, governor.reason};
+    }
+    return reconstructPath(forward_meet, backward_meet);
+}
+
+// Expande la capa actual de un lado entero. Todos los estados de la capa
+// tienen la misma profundidad, asi que el mejor encuentro sale de comparar la
+// profundidad del estado del otro lado. Devuelve false si se paso un tope
+bool BidirectionalSearch::expandLayer(bool forward, State *&forward_meet,
+                                      State *&backward_meet) {
+    TRACE_SCOPE;
+    Frontier &frontier = forward ? forward_frontier : backward_frontier;
+    HashTable &seen = forward ? forward_seen : backward_seen;
+    HashTable &other_seen = forward ? backward_seen : forward_seen;
+    Frontier next;
+    unsigned int best_length = 0;
+
+    for (size_t k = 0; k < frontier.count; k++) {
+        State *current = frontier.states[k];
+        unsigned int num_neighbors = 0;
+        State **neighbors =
+            forward ? current->generateSuccessors(capacities, num_neighbors,
+                                                  &state_pool)
+                    : current->generatePredecessors(capacities, num_neighbors,
+                                                    &state_pool);
+        expanded++;
+
+        for (unsigned int i = 0; i < num_neighbors; i++) {
+            State *neighbor = neighbors[i];
+            if (!seen.insert(neighbor)) {
+                state_pool.release(neighbor);
+                continue;
+            }
+            next.push(neighbor);
+
+            State *other = other_seen.lookup(neighbor);
+            if (other) {
+                unsigned int length = neighbor->depth + other->depth;
+                if (!forward_meet || length < best_length) {
+                    best_length = length;
+                    forward_meet = forward ? neighbor : other;
+                    backward_meet = forward ? other : neighbor;
+                }
+            }
+        }
+        delete[] neighbors;
+
+        if (governor.exceeded(expanded, state_pool.live_states,
+                              reservedBytes())) {
+            return false;
+        }
+    }
+
+    frontier.swap(next);
+    return true;
+}
+
+// camino de ida hasta el encuentro y luego la cadena del frente de atras,
+// sin repetir el estado del encuentro
+Search::Path BidirectionalSearch::reconstructPath(State *forward_meet,
+                                                  State *backward_meet) const {
+    TRACE_SCOPE;
+    unsigned int forward_length = 0;
+    for (State *s = forward_meet; s; s = s->parent) {
+        forward_length++;
+    }
+    unsigned int length = forward_length;
+    for (State *s = backward_meet->parent; s; s = s->parent) {
+        length++;
+    }
+
+    State **path_states = new State *[length];
+    unsigned int index = forward_length;
+    for (State *s = forward_meet; s; s = s->parent) {
+        path_states[--index] = s;
+    }
+    index = forward_length;
+    for (State *s = backward_meet->parent; s; s = s->parent) {
+        path_states[index++] = s;
+    }
+
+    return {path_states, length, length - 1, StopReason::COMPLETED};
+}
+
+size_t BidirectionalSearch::reservedBytes() const {
+    return state_pool.reservedBytes() + forward_seen.reservedBytes() +
+           backward_seen.reservedBytes() +
+           (forward_frontier.capacity + backward_frontier.capacity) *
+               sizeof(State *);
+}
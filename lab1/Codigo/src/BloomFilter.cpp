@@ -0,0 +1,43 @@
+#include "../include/BloomFilter.h"
+
+BloomFilter::BloomFilter(size_t max_bytes, unsigned int num_hashes) {
+    this->num_words = 1;
+    while (num_words * 2 * sizeof(uint64_t) <= max_bytes) {
+        num_words *= 2;
+    }
+    this->bits = new uint64_t[num_words]();
+    this->mask = static_cast<uint64_t>(num_words) * 64 - 1;
+    this->num_hashes = num_hashes;
+}
+
+BloomFilter::~BloomFilter() { delete[] bits; }
+
+// la segunda mitad del hash, impar, es el paso entre posiciones
+void BloomFilter::add(uint64_t hash) {
+    uint64_t step = (hash >> 32 | hash << 32) | 1;
+    for (unsigned int i = 0; i < num_hashes; i++) {
+        uint64_t bit = (hash + i * step) & mask;
+        bits[bit >> 6] |= 1ull << (bit & 63);
+    }
+}
+
+bool BloomFilter::mayContain(uint64_t hash) const {
+    uint64_t step = (hash >> 32 | hash << 32) | 1;
+    for (unsigned int i = 0; i < num_hashes; i++) {
+        uint64_t bit = (hash + i * step) & mask;
+        if (!(bits[bit >> 6] & (1ull << (bit & 63)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BloomFilter::clear() {
+    for (size_t i = 0; i < num_words; i++) {
+        bits[i] = 0;
+    }
+}
+
+size_t BloomFilter::reservedBytes() const {
+    return num_words * sizeof(uint64_t);
+}
@@ -0,0 +1,135 @@
+#include "../include/BucketQueue.h"
+
+BucketQueue::BucketQueue(TieBreak tie_break) {
+    TRACE_SCOPE;
+    this->tie_break = tie_break;
+    this->num_buckets = INITIAL_BUCKETS;
+    this->buckets = new Bucket[num_buckets]();
+    this->min_bucket = num_buckets;
+    this->size = 0;
+}
+
+BucketQueue::~BucketQueue() {
+    TRACE_SCOPE;
+    for (unsigned int i = 0; i < num_buckets; i++) {
+        delete[] buckets[i].items;
+    }
+    delete[] buckets;
+}
+
+void BucketQueue::push(State *state) {
+    TRACE_SCOPE;
+    unsigned int weight = state->weight;
+    if (weight >= num_buckets) {
+        growBuckets(weight);
+    }
+
+    Bucket &bucket = buckets[weight];
+    if (bucket.count == bucket.capacity) {
+        // si lo sacado por FIFO ocupa la mitad, se compacta antes de crecer
+        if (bucket.head > 0 && bucket.head >= bucket.capacity / 2) {
+            memmove(bucket.items, bucket.items + bucket.head,
+                    (bucket.count - bucket.head) * sizeof(State *));
+            bucket.count -= bucket.head;
+            bucket.head = 0;
+        } else {
+            unsigned int new_capacity = bucket.capacity
+                                            ? bucket.capacity * 2
+                                            : INITIAL_BUCKET_CAPACITY;
+            State **items = new State *[new_capacity];
+            if (bucket.items) {
+                memcpy(items, bucket.items, bucket.count * sizeof(State *));
+                delete[] bucket.items;
+            }
+            bucket.items = items;
+            bucket.capacity = new_capacity;
+        }
+    }
+    bucket.items[bucket.count++] = state;
+
+    if (weight < min_bucket) {
+        min_bucket = weight;
+    }
+    size++;
+    TRACE_PLOT("BucketQueue/Stats/Size", static_cast<int64_t>(size));
+}
+
+State *BucketQueue::pop() {
+    TRACE_SCOPE;
+    min_bucket = firstNonEmpty();
+    if (min_bucket >= num_buckets) {
+        return nullptr;
+    }
+
+    Bucket &bucket = buckets[min_bucket];
+    State *result;
+    if (tie_break == TieBreak::FIFO) {
+        result = bucket.items[bucket.head++];
+    } else {
+        result = bucket.items[--bucket.count];
+    }
+    if (bucket.head == bucket.count) {
+        bucket.head = 0;
+        bucket.count = 0;
+    }
+    size--;
+    return result;
+}
+
+State *BucketQueue::peek() const {
+    unsigned int first = firstNonEmpty();
+    if (first >= num_buckets) {
+        return nullptr;
+    }
+    const Bucket &bucket = buckets[first];
+    return tie_break == TieBreak::FIFO ? bucket.items[bucket.head]
+                                       : bucket.items[bucket.count - 1];
+}
+
+// los arreglos de cada bucket se mantienen para reutilizarlos
+void BucketQueue::clear() {
+    TRACE_SCOPE;
+    for (unsigned int i = 0; i < num_buckets; i++) {
+        buckets[i].head = 0;
+        buckets[i].count = 0;
+    }
+    min_bucket = num_buckets;
+    size = 0;
+}
+
+bool BucketQueue::empty() const { return size == 0; }
+
+size_t BucketQueue::reservedBytes() const {
+    return num_buckets * sizeof(Bucket) + size * sizeof(State *);
+}
+
+void BucketQueue::growBuckets(unsigned int weight) {
+    unsigned int new_count = num_buckets;
+    while (new_count <= weight && new_count < (1u << 31)) {
+        new_count *= 2;
+    }
+    if (new_count <= weight) {
+        new_count = weight + 1;
+    }
+    Bucket *bigger = new Bucket[new_count]();
+    memcpy(bigger, buckets, num_buckets * sizeof(Bucket));
+    delete[] buckets;
+    if (min_bucket == num_buckets) {
+        min_bucket = new_count;
+    }
+    buckets = bigger;
+    num_buckets = new_count;
+}
+
+// el cursor solo avanza, cada bucket vacio se salta una vez hasta que un push
+// lo vuelva a mover hacia atras
+unsigned int BucketQueue::firstNonEmpty() const {
+    if (size == 0) {
+        return num_buckets;
+    }
+    unsigned int i = min_bucket;
+    while (i < num_buckets && buckets[i].head == buckets[i].count) {
+        i++;
+    }
+    return i;
+}
@@ -0,0 +1,57 @@
+#include "../include/ClosedSet.h"
+
+ClosedSet::ClosedSet(ClosedSetBackend backend,
+                     const HashTable::Config &config) {
+    this->config = config;
+    this->backend = backend;
+    this->robin_hood = nullptr;
+    this->swiss = nullptr;
+    this->compact = nullptr;
+    setBackend(backend);
+}
+
+// los estados son del pool del Search, aca solo se libera la tabla
+ClosedSet::~ClosedSet() { release(); }
+
+// cambiar de backend descarta lo que tuviera la tabla anterior
+void ClosedSet::setBackend(ClosedSetBackend backend) {
+    if (this->backend == backend && (robin_hood || swiss || compact)) {
+        return;
+    }
+    release();
+    this->backend = backend;
+    if (backend == ClosedSetBackend::ROBIN_HOOD) {
+        robin_hood = new HashTable(config);
+    } else if (backend == ClosedSetBackend::SWISS) {
+        swiss = new SwissTable();
+    } else {
+        compact = new CompactClosedSet();
+    }
+}
+
+const char *ClosedSet::backendName(ClosedSetBackend backend) {
+    switch (backend) {
+        case ClosedSetBackend::ROBIN_HOOD:
+            return "robin hood";
+        case ClosedSetBackend::SWISS:
+            return "swiss";
+        case ClosedSetBackend::COMPACT:
+            return "compact";
+    }
+    return "unknown";
+}
+
+void ClosedSet::release() {
+    if (robin_hood) {
+        robin_hood->clear();
+        delete robin_hood;
+        robin_hood = nullptr;
+    }
+    if (swiss) {
+        swiss->clear();
+        delete swiss;
+        swiss = nullptr;
+    }
+    delete compact;
+    compact = nullptr;
+}
@@ -0,0 +1,196 @@
+#include "../include/CompactClosedSet.h"
+#include <cassert>
+#include <cstring>
+
+// los registros se reservan con el primer estado, que trae el largo de la
+// llave
+CompactClosedSet::CompactClosedSet() {
+    TRACE_SCOPE;
+    this->key_words = 0;
+    this->keys = nullptr;
+    this->parents = nullptr;
+    this->moves = nullptr;
+    this->num_nodes = 0;
+    this->nodes_capacity = 0;
+    this->capacity = INITIAL_SLOTS;
+    this->slots = new Slot[capacity];
+    this->size = 0;
+    clear();
+}
+
+CompactClosedSet::~CompactClosedSet() {
+    TRACE_SCOPE;
+    delete[] keys;
+    delete[] parents;
+    delete[] moves;
+    delete[] slots;
+}
+
+bool CompactClosedSet::insert(State *state) {
+    TRACE_SCOPE;
+    if (!state)
+        return false;
+
+    uint32_t hash = hashOf(state);
+    if (find(state, hash) >= 0) {
+        return false;
+    }
+    if (size + 1 > capacity * MAX_LOAD_FACTOR) {
+        growSlots();
+    }
+    // el registro de EPEA se reutiliza; un indice de otro closed set (o de
+    // antes de clear) no corresponde a la llave
+    uint32_t node = state->node;
+    if (node >= num_nodes || !matches(node, state)) {
+        node = record(state);
+    }
+    placeSlot(hash, node);
+    size++;
+    return true;
+}
+
+bool CompactClosedSet::contains(const State *state) const {
+    TRACE_SCOPE;
+    if (!state)
+        return false;
+    return find(state, hashOf(state)) >= 0;
+}
+
+bool CompactClosedSet::closedAs(const State *state) const {
+    if (!state || state->node == State::NO_NODE)
+        return false;
+    long long pos = find(state, hashOf(state));
+    return pos >= 0 && slots[pos].node == state->node;
+}
+
+uint32_t CompactClosedSet::record(State *state) {
+    assert(state->key);
+    if (!keys) {
+        key_words = state->key_words;
+    }
+    assert(state->key_words == key_words);
+    if (num_nodes == nodes_capacity) {
+        growNodes();
+    }
+    uint32_t node = static_cast<uint32_t>(num_nodes++);
+    memcpy(keys + static_cast<size_t>(node) * key_words, state->key,
+           key_words * sizeof(uint64_t));
+    parents[node] = state->parent_node;
+    moves[node] = state->move_code;
+    state->node = node;
+    return node;
+}
+
+// borrado con desplazamiento hacia atras: los slots siguientes del mismo
+// tramo se corren para no dejar huecos en su sondeo
+void CompactClosedSet::removeState(State *state) {
+    if (!state)
+        return;
+    long long found = find(state, hashOf(state));
+    if (found < 0)
+        return;
+
+    size_t mask = capacity - 1;
+    size_t hole = static_cast<size_t>(found);
+    size_t pos = (hole + 1) & mask;
+    while (slots[pos].node != State::NO_NODE) {
+        size_t home = slots[pos].hash & mask;
+        // se mueve si su posicion de inicio no queda entre el hueco y pos
+        if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+            slots[hole] = slots[pos];
+            hole = pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+    slots[hole].node = State::NO_NODE;
+    size--;
+}
+
+// olvida registros e indice sin devolver la memoria
+void CompactClosedSet::clear() {
+    for (size_t i = 0; i < capacity; i++) {
+        slots[i].node = State::NO_NODE;
+    }
+    size = 0;
+    num_nodes = 0;
+}
+
+size_t CompactClosedSet::reservedBytes() const {
+    return nodes_capacity * (key_words * sizeof(uint64_t) + sizeof(uint32_t) +
+                             sizeof(uint16_t)) +
+           capacity * sizeof(Slot);
+}
+
+uint32_t CompactClosedSet::hashOf(const State *state) {
+    uint64_t hash = HashTable::computeHash(state);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+bool CompactClosedSet::matches(uint32_t node, const State *state) const {
+    const uint64_t *key = keys + static_cast<size_t>(node) * key_words;
+    for (unsigned int w = 0; w < key_words; w++) {
+        if (key[w] != state->key[w]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+long long CompactClosedSet::find(const State *state, uint32_t hash) const {
+    size_t mask = capacity - 1;
+    for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+        const Slot &slot = slots[pos];
+        if (slot.node == State::NO_NODE) {
+            return -1;
+        }
+        if (slot.hash == hash && matches(slot.node, state)) {
+            return static_cast<long long>(pos);
+        }
+    }
+}
+
+void CompactClosedSet::placeSlot(uint32_t hash, uint32_t node) {
+    size_t mask = capacity - 1;
+    size_t pos = hash & mask;
+    while (slots[pos].node != State::NO_NODE) {
+        pos = (pos + 1) & mask;
+    }
+    slots[pos].hash = hash;
+    slots[pos].node = node;
+}
+
+void CompactClosedSet::growNodes() {
+    size_t new_capacity = nodes_capacity ? nodes_capacity * 2 : INITIAL_NODES;
+    uint64_t *new_keys = new uint64_t[new_capacity * key_words];
+    uint32_t *new_parents = new uint32_t[new_capacity];
+    uint16_t *new_moves = new uint16_t[new_capacity];
+    if (num_nodes > 0) {
+        memcpy(new_keys, keys, num_nodes * key_words * sizeof(uint64_t));
+        memcpy(new_parents, parents, num_nodes * sizeof(uint32_t));
+        memcpy(new_moves, moves, num_nodes * sizeof(uint16_t));
+    }
+    delete[] keys;
+    delete[] parents;
+    delete[] moves;
+    keys = new_keys;
+    parents = new_parents;
+    moves = new_moves;
+    nodes_capacity = new_capacity;
+}
+
+// el hash de 32 bits va en el slot, asi que se reubica sin mirar las llaves
+void CompactClosedSet::growSlots() {
+    Slot *old_slots = slots;
+    size_t old_capacity = capacity;
+    capacity *= 2;
+    slots = new Slot[capacity];
+    for (size_t i = 0; i < capacity; i++) {
+        slots[i].node = State::NO_NODE;
+    }
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].node != State::NO_NODE) {
+            placeSlot(old_slots[i].hash, old_slots[i].node);
+        }
+    }
+    delete[] old_slots;
+}
@@ -0,0 +1,263 @@
+#include "../include/DenseSearch.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+DenseSearch::DenseSearch(State *initial_state, State *target_state,
+                         const unsigned int *capacities,
+                         const SearchLimits &limits, unsigned int num_threads)
+    : radix(capacities, initial_state->size),
+      state_pool(initial_state->size), governor(limits) {
+    TRACE_SCOPE;
+    this->capacities = capacities;
+    this->size = initial_state->size;
+    this->start_rank = rankOf(initial_state->jugs);
+    this->goal_rank = rankOf(target_state->jugs);
+    this->visited_words = (radix.total + 63) / 64;
+    this->visited = new std::atomic<uint64_t>[visited_words];
+    // solo se leen las posiciones ya visitadas, no hace falta limpiarlos
+    this->parents = new uint32_t[radix.total];
+    this->queue = new uint32_t[radix.total];
+    this->queue_tail = 0;
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    this->num_threads = num_threads;
+    this->buffers = new Buffer[num_threads];
+    for (unsigned int t = 0; t < num_threads; t++) {
+        buffers[t] = {nullptr, 0, 0};
+    }
+    this->worker_jugs = new unsigned int[num_threads * size];
+    this->expanded = 0;
+    this->level_bytes = 0;
+}
+
+DenseSearch::~DenseSearch() {
+    TRACE_SCOPE;
+    for (unsigned int t = 0; t < num_threads; t++) {
+        delete[] buffers[t].ranks;
+    }
+    delete[] buffers;
+    delete[] worker_jugs;
+    delete[] visited;
+    delete[] parents;
+    delete[] queue;
+}
+
+bool DenseSearch::fits(const unsigned int *capacities, unsigned int size,
+                       uint64_t max_states) {
+    uint64_t total = MixedRadix::spaceSize(capacities, size);
+    return total > 0 && total <= max_states && total < NO_RANK;
+}
+
+// si se corta expandiendo la capa d, todo lo que esta a d o menos ya se vio
+// y el objetivo no estaba
+Search::Path DenseSearch::findPath() {
+    TRACE_SCOPE;
+    Search::Path path = {nullptr, 0, 0, StopReason::COMPLETED};
+    governor = LimitGovernor(governor.limits);
+    for (uint64_t w = 0; w < visited_words; w++) {
+        visited[w].store(0, std::memory_order_relaxed);
+    }
+    queue_tail = 0;
+    expanded = 0;
+
+    bool found = false;
+    if (start_rank != NO_RANK) {
+        visited[start_rank >> 6].store(1ull << (start_rank & 63),
+                                       std::memory_order_relaxed);
+        parents[start_rank] = NO_RANK;
+        queue[queue_tail++] = start_rank;
+        found = start_rank == goal_rank;
+    }
+    unsigned int depth = 0;
+    size_t level_begin = 0;
+    while (!found && level_begin < queue_tail) {
+        size_t level_end = queue_tail;
+        bool halted = expandLevel(level_begin, level_end);
+        found = goal_rank != NO_RANK && isVisited(goal_rank);
+        if (halted && !found) {
+            path = {nullptr, 0, depth + 1, governor.reason};
+            break;
+        }
+        level_begin = level_end;
+        depth++;
+    }
+    if (found) {
+        path = buildPath();
+    }
+
+    std::cout << "\nSearch statistics:" << std::endl;
+    std::cout << "Dense states: " << radix.total << ", visited: "
+              << queue_tail << ", expanded: " << expanded << ", threads: "
+              << num_threads << std::endl;
+    return path;
+}
+
+bool DenseSearch::expandLevel(size_t begin, size_t end) {
+    TRACE_SCOPE;
+    unsigned int workers =
+        end - begin >= PARALLEL_MIN_LEVEL ? num_threads : 1;
+    bool concurrent = workers > 1;
+    std::atomic<size_t> next(begin);
+    std::atomic<size_t> level_expanded(0);
+    std::atomic<bool> halt(false);
+    level_bytes = reservedBytes();
+
+    std::thread *threads = new std::thread[workers - 1];
+    for (unsigned int t = 1; t < workers; t++) {
+        threads[t - 1] = std::thread(
+            &DenseSearch::expandChunks, this, t, end, std::ref(next),
+            std::ref(level_expanded), std::ref(halt), concurrent);
+    }
+    expandChunks(0, end, next, level_expanded, halt, concurrent);
+    for (unsigned int t = 1; t < workers; t++) {
+        threads[t - 1].join();
+    }
+    delete[] threads;
+
+    // cada estado se reclama una sola vez, la cola nunca pasa de total. Un
+    // buffer que nunca recibio nada no tiene arreglo
+    for (unsigned int t = 0; t < workers; t++) {
+        if (buffers[t].count == 0) {
+            continue;
+        }
+        memcpy(queue + queue_tail, buffers[t].ranks,
+               buffers[t].count * sizeof(uint32_t));
+        queue_tail += buffers[t].count;
+    }
+    expanded += level_expanded.load();
+    return halt.load();
+}
+
+void DenseSearch::expandChunks(unsigned int worker, size_t end,
+                               std::atomic<size_t> &next,
+                               std::atomic<size_t> &level_expanded,
+                               std::atomic<bool> &halt, bool concurrent) {
+    unsigned int *jugs = worker_jugs + worker * size;
+    Buffer &buffer = buffers[worker];
+    buffer.count = 0;
+    bool found = false;
+
+    while (!halt.load(std::memory_order_relaxed)) {
+        if (worker == 0 &&
+            governor.exceeded(expanded + level_expanded.load(), queue_tail,
+                              level_bytes)) {
+            halt.store(true);
+            break;
+        }
+        size_t begin = next.fetch_add(CHUNK_SIZE);
+        if (begin >= end) {
+            break;
+        }
+        size_t chunk_end = std::min(begin + CHUNK_SIZE, end);
+        for (size_t k = begin; k < chunk_end; k++) {
+            uint32_t rank = queue[k];
+            radix.decode(rank, jugs);
+            for (unsigned int i = 0; i < size; i++) {
+                uint64_t from_stride = radix.stride[i];
+                unsigned int amount = jugs[i];
+                if (amount < capacities[i]) {
+                    found |= claim(rank + (capacities[i] - amount) *
+                                              from_stride,
+                                   rank, buffer, concurrent);
+                }
+                if (amount == 0) {
+                    continue;
+                }
+                found |= claim(rank - amount * from_stride, rank, buffer,
+                               concurrent);
+                for (unsigned int j = 0; j < size; j++) {
+                    if (j == i || jugs[j] == capacities[j]) {
+                        continue;
+                    }
+                    uint64_t poured =
+                        std::min(amount, capacities[j] - jugs[j]);
+                    found |= claim(rank - poured * from_stride +
+                                       poured * radix.stride[j],
+                                   rank, buffer, concurrent);
+                }
+            }
+        }
+        level_expanded.fetch_add(chunk_end - begin);
+        if (found) {
+            halt.store(true);
+        }
+    }
+}
+
+bool DenseSearch::claim(uint64_t rank, uint32_t parent, Buffer &buffer,
+                        bool concurrent) {
+    std::atomic<uint64_t> &word = visited[rank >> 6];
+    uint64_t bit = 1ull << (rank & 63);
+    uint64_t before = word.load(std::memory_order_relaxed);
+    if (before & bit) {
+        return false;
+    }
+    if (concurrent) {
+        if (word.fetch_or(bit, std::memory_order_relaxed) & bit) {
+            return false;
+        }
+    } else {
+        word.store(before | bit, std::memory_order_relaxed);
+    }
+    parents[rank] = parent;
+    if (buffer.count == buffer.capacity) {
+        size_t new_capacity = buffer.capacity ? buffer.capacity * 2 : 1024;
+        uint32_t *ranks = new uint32_t[new_capacity];
+        if (buffer.count > 0) {
+            memcpy(ranks, buffer.ranks, buffer.count * sizeof(uint32_t));
+        }
+        delete[] buffer.ranks;
+        buffer.ranks = ranks;
+        buffer.capacity = new_capacity;
+    }
+    buffer.ranks[buffer.count++] = static_cast<uint32_t>(rank);
+    return rank == goal_rank;
+}
+
+bool DenseSearch::isVisited(uint64_t rank) const {
+    return visited[rank >> 6].load(std::memory_order_relaxed) &
+           (1ull << (rank & 63));
+}
+
+// se cuenta el largo siguiendo los padres y se crean los States del inicio
+// al objetivo
+Search::Path DenseSearch::buildPath() {
+    TRACE_SCOPE;
+    unsigned int length = 0;
+    for (uint32_t rank = goal_rank; rank != NO_RANK; rank = parents[rank]) {
+        length++;
+    }
+    State **path_states = new State *[length];
+    uint32_t rank = goal_rank;
+    unsigned int *jugs = worker_jugs;
+    for (unsigned int i = length; i-- > 0; rank = parents[rank]) {
+        radix.decode(rank, jugs);
+        path_states[i] = state_pool.allocate(jugs, i, 0, nullptr);
+    }
+    for (unsigned int i = 1; i < length; i++) {
+        path_states[i]->parent = path_states[i - 1];
+    }
+    return {path_states, length, length - 1, StopReason::COMPLETED};
+}
+
+uint32_t DenseSearch::rankOf(const unsigned int *values) const {
+    for (unsigned int i = 0; i < size; i++) {
+        if (values[i] > capacities[i]) {
+            return NO_RANK;
+        }
+    }
+    return static_cast<uint32_t>(radix.index(values));
+}
+
+size_t DenseSearch::reservedBytes() const {
+    size_t bytes = state_pool.reservedBytes() +
+                   visited_words * sizeof(uint64_t) +
+                   radix.total * 2 * sizeof(uint32_t);
+    for (unsigned int t = 0; t < num_threads; t++) {
+        bytes += buffers[t].capacity * sizeof(uint32_t);
+    }
+    return bytes;
+}
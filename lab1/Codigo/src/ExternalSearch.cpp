@@ -0,0 +1,514 @@
+#include "../include/ExternalSearch.h"
+#include <algorithm>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// std::max la toma por referencia, en C++11 necesita definicion
+constexpr size_t ExternalSearch::BLOCK_KEYS;
+
+ExternalSearch::ExternalSearch(State *initial_state, State *target_state,
+                               const unsigned int *capacities,
+                               size_t memory_budget,
+                               const std::string &work_dir,
+                               const SearchLimits &limits)
+    : encoding(capacities, initial_state->size),
+      state_pool(initial_state->size, &encoding),
+      seen(memory_budget / BLOOM_SHARE), governor(limits) {
+    TRACE_SCOPE;
+    this->capacities = capacities;
+    this->target_state = target_state;
+    this->size = initial_state->size;
+    this->key_words = encoding.words;
+    this->start_state =
+        state_pool.allocate(initial_state->jugs, 0, 0, nullptr);
+    this->cursor = state_pool.allocate(initial_state->jugs, 0, 0, nullptr);
+    this->work_dir = work_dir;
+    // el pid en el nombre deja correr dos busquedas en el mismo directorio
+    this->file_prefix =
+        work_dir + "/ext_" + std::to_string(static_cast<long>(getpid())) + "_";
+    this->goal_key = new uint64_t[key_words];
+    encoding.pack(target_state->jugs, goal_key);
+    this->layers = nullptr;
+    this->num_layers = 0;
+    this->layers_capacity = 0;
+
+    // cada hijo en el buffer cuesta su llave y su indice en run_order
+    size_t entry_bytes = key_words * sizeof(uint64_t) + sizeof(uint32_t);
+    size_t run_bytes = memory_budget > seen.reservedBytes()
+                           ? memory_budget - seen.reservedBytes()
+                           : 0;
+    this->run_capacity = std::min<size_t>(
+        std::max<size_t>(run_bytes / entry_bytes, BLOCK_KEYS), 0xFFFFFFFFu);
+    this->run_keys = new uint64_t[run_capacity * key_words];
+    this->run_order = new uint32_t[run_capacity];
+    this->run_size = 0;
+    this->num_runs = 0;
+    this->expanded = 0;
+    this->stored = 0;
+    this->bloom_skips = 0;
+    this->disk_probes = 0;
+    this->block_reads = 0;
+    this->io_error = false;
+}
+
+ExternalSearch::~ExternalSearch() {
+    TRACE_SCOPE;
+    removeFiles();
+    delete[] layers;
+    delete[] run_keys;
+    delete[] run_order;
+    delete[] goal_key;
+}
+
+// BFS por capas: la capa 0 es el inicial, y cada capa nueva sale de expandir
+// la anterior y mezclar sus corridas. Termina al escribir el objetivo, con
+// una capa vacia (sin solucion) o al pasarse un tope
+Search::Path ExternalSearch::findPath() {
+    TRACE_SCOPE;
+    Search::Path path = {nullptr, 0, 0, StopReason::COMPLETED};
+    governor = LimitGovernor(governor.limits);
+    removeFiles();
+    seen.clear();
+    io_error = false;
+    mkdir(work_dir.c_str(), 0755);
+
+    encoding.pack(start_state->jugs, run_keys);
+    run_size = 1;
+    bool found = false;
+    bool running = flushRun() && mergeRuns(found);
+    // capas completas sin el objetivo: el optimo tiene al menos tantos pasos
+    unsigned int complete = 0;
+    while (running && !found && layers[num_layers - 1].size > 0) {
+        complete = num_layers;
+        running = expandLayer(num_layers - 1) && mergeRuns(found);
+    }
+
+    if (found) {
+        path = buildPath(num_layers - 1);
+    } else if (governor.reason != StopReason::COMPLETED) {
+        path = {nullptr, 0, complete, governor.reason};
+    }
+    if (io_error) {
+        std::cerr << "Error de lectura o escritura en " << work_dir << "/\n";
+    }
+
+    std::cout << "\nSearch statistics:" << std::endl;
+    std::cout << "Expanded states: " << expanded << std::endl;
+    std::cout << "Layers: " << num_layers << ", states on disk: " << stored
+              << std::endl;
+    std::cout << "Bloom skips: " << bloom_skips
+              << ", disk probes: " << disk_probes
+              << ", block reads: " << block_reads << std::endl;
+    return path;
+}
+
+// los hijos de cada estado salen de su llave cambiando solo los campos de
+// las jarras que toca el movimiento
+bool ExternalSearch::expandLayer(unsigned int layer) {
+    TRACE_SCOPE;
+    Reader &reader = layers[layer].reader;
+    if (!reader.file && !openReader(reader, layerPath(layer))) {
+        return false;
+    }
+    State::Move *moves = new State::Move[size * (size + 1)];
+    unsigned int *child_jugs = new unsigned int[size];
+    bool ok = true;
+
+    reader.pos = reader.count;
+    reader.block = NO_BLOCK;
+    for (const uint64_t *key = peek(reader); ok && key;
+         advance(reader), key = peek(reader)) {
+        if (governor.exceeded(expanded, run_size, reservedBytes())) {
+            ok = false;
+            break;
+        }
+        encoding.unpack(key, cursor->jugs);
+        memcpy(child_jugs, cursor->jugs, size * sizeof(unsigned int));
+        unsigned int num_moves = cursor->generateMoves(capacities, moves);
+        for (unsigned int m = 0; m < num_moves; m++) {
+            if (run_size == run_capacity && !flushRun()) {
+                ok = false;
+                break;
+            }
+            const State::Move &move = moves[m];
+            cursor->applyMove(move, capacities, child_jugs);
+            uint64_t *child = run_keys + run_size * key_words;
+            memcpy(child, key, key_words * sizeof(uint64_t));
+            encoding.set(child, move.from, child_jugs[move.from]);
+            encoding.set(child, move.to, child_jugs[move.to]);
+            child_jugs[move.from] = cursor->jugs[move.from];
+            child_jugs[move.to] = cursor->jugs[move.to];
+            run_size++;
+        }
+        expanded++;
+    }
+
+    delete[] moves;
+    delete[] child_jugs;
+    return ok && !io_error && flushRun();
+}
+
+bool ExternalSearch::flushRun() {
+    TRACE_SCOPE;
+    if (run_size == 0) {
+        return true;
+    }
+    for (size_t i = 0; i < run_size; i++) {
+        run_order[i] = static_cast<uint32_t>(i);
+    }
+    const uint64_t *keys = run_keys;
+    unsigned int words = key_words;
+    std::sort(run_order, run_order + run_size,
+              [keys, words](uint32_t a, uint32_t b) {
+                  return compareKeys(keys + static_cast<size_t>(a) * words,
+                                     keys + static_cast<size_t>(b) * words,
+                                     words) < 0;
+              });
+
+    FILE *file = std::fopen(runPath(num_runs).c_str(), "wb");
+    if (!file) {
+        io_error = true;
+        return false;
+    }
+    num_runs++;
+    bool ok = true;
+    const uint64_t *last = nullptr;
+    for (size_t i = 0; i < run_size && ok; i++) {
+        const uint64_t *key = keys + static_cast<size_t>(run_order[i]) * words;
+        if (last && compareKeys(last, key, words) == 0) {
+            continue;
+        }
+        ok = std::fwrite(key, sizeof(uint64_t), words, file) == words;
+        last = key;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    run_size = 0;
+    io_error = io_error || !ok;
+    return ok;
+}
+
+// mezcla de k vias: la menor llave entre las corridas, una sola vez aunque
+// este en varias. Las candidatas salen ordenadas, asi que los bloques que se
+// leen de cada capa anterior van en orden
+bool ExternalSearch::mergeRuns(bool &found) {
+    TRACE_SCOPE;
+    found = false;
+    unsigned int index = addLayer();
+    FILE *out = std::fopen(layerPath(index).c_str(), "wb");
+    if (!out) {
+        io_error = true;
+        return false;
+    }
+    std::setvbuf(out, nullptr, _IOFBF, 1 << 20);
+
+    Reader *runs = new Reader[num_runs];
+    bool ok = true;
+    for (unsigned int r = 0; r < num_runs; r++) {
+        runs[r] = {nullptr, nullptr, 0, 0, NO_BLOCK};
+        ok = ok && openReader(runs[r], runPath(r));
+    }
+    uint64_t *candidate = new uint64_t[key_words];
+
+    while (ok) {
+        if (governor.exceeded(expanded, run_size, reservedBytes())) {
+            ok = false;
+            break;
+        }
+        const uint64_t *smallest = nullptr;
+        for (unsigned int r = 0; r < num_runs; r++) {
+            const uint64_t *key = peek(runs[r]);
+            if (key && (!smallest ||
+                        compareKeys(key, smallest, key_words) < 0)) {
+                smallest = key;
+            }
+        }
+        if (!smallest) {
+            break;
+        }
+        memcpy(candidate, smallest, key_words * sizeof(uint64_t));
+        for (unsigned int r = 0; r < num_runs; r++) {
+            const uint64_t *key = peek(runs[r]);
+            if (key && compareKeys(key, candidate, key_words) == 0) {
+                advance(runs[r]);
+            }
+        }
+
+        // si el filtro no la tiene es nueva; si no, se busca desde la capa
+        // mas reciente, donde caen casi todos los repetidos
+        uint64_t hash = keyHash(candidate, key_words);
+        bool duplicate = false;
+        if (!seen.mayContain(hash)) {
+            bloom_skips++;
+        } else {
+            disk_probes++;
+            for (unsigned int l = index; l-- > 0 && !duplicate;) {
+                duplicate = inLayer(l, candidate);
+            }
+        }
+        if (duplicate) {
+            continue;
+        }
+
+        Layer &layer = layers[index];
+        if (layer.size % BLOCK_KEYS == 0) {
+            addFence(layer, candidate);
+        }
+        if (std::fwrite(candidate, sizeof(uint64_t), key_words, out) !=
+            key_words) {
+            io_error = true;
+            ok = false;
+            break;
+        }
+        layer.size++;
+        stored++;
+        seen.add(hash);
+        if (compareKeys(candidate, goal_key, key_words) == 0) {
+            found = true;
+            break;
+        }
+    }
+
+    for (unsigned int r = 0; r < num_runs; r++) {
+        closeReader(runs[r]);
+        std::remove(runPath(r).c_str());
+    }
+    delete[] runs;
+    delete[] candidate;
+    num_runs = 0;
+    if (std::fclose(out) != 0) {
+        io_error = true;
+        ok = false;
+    }
+    return ok && !io_error;
+}
+
+// el unico bloque que puede tener la llave es el ultimo cuya primera llave
+// no es mayor; se lee si no es el que ya esta cargado y se busca adentro
+bool ExternalSearch::inLayer(unsigned int layer, const uint64_t *key) {
+    Layer &current = layers[layer];
+    size_t low = 0;
+    size_t high = current.num_fences;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (compareKeys(current.fences + mid * key_words, key, key_words) <=
+            0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0) {
+        return false;
+    }
+    Reader &reader = current.reader;
+    if (!reader.file && !openReader(reader, layerPath(layer))) {
+        return false;
+    }
+    if (reader.block != low - 1) {
+        if (!loadBlock(reader, low - 1)) {
+            io_error = true;
+            return false;
+        }
+        block_reads++;
+    }
+
+    low = 0;
+    high = reader.count;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        int order = compareKeys(reader.buffer + mid * key_words, key,
+                                key_words);
+        if (order == 0) {
+            return true;
+        }
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return false;
+}
+
+// hacia atras desde el objetivo: en la capa k hay algun predecesor del
+// estado de la capa k + 1, y se busca con el mismo indice de bloques
+Search::Path ExternalSearch::buildPath(unsigned int goal_layer) {
+    TRACE_SCOPE;
+    State **path_states = new State *[goal_layer + 1];
+    path_states[goal_layer] =
+        state_pool.allocate(target_state->jugs, goal_layer, 0, nullptr);
+    for (unsigned int k = goal_layer; k-- > 0;) {
+        unsigned int num_predecessors;
+        State **predecessors = path_states[k + 1]->generatePredecessors(
+            capacities, num_predecessors, &state_pool);
+        path_states[k] = nullptr;
+        for (unsigned int i = 0; i < num_predecessors; i++) {
+            if (!path_states[k] && inLayer(k, predecessors[i]->key)) {
+                path_states[k] = predecessors[i];
+                path_states[k]->depth = k;
+                path_states[k + 1]->parent = path_states[k];
+            } else {
+                state_pool.release(predecessors[i]);
+            }
+        }
+        delete[] predecessors;
+        // solo si no se pudo leer la capa
+        if (!path_states[k]) {
+            delete[] path_states;
+            return {nullptr, 0, goal_layer, StopReason::COMPLETED};
+        }
+    }
+    return {path_states, goal_layer + 1, goal_layer, StopReason::COMPLETED};
+}
+
+int ExternalSearch::compareKeys(const uint64_t *a, const uint64_t *b,
+                                unsigned int words) {
+    for (unsigned int w = 0; w < words; w++) {
+        if (a[w] != b[w]) {
+            return a[w] < b[w] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// splitmix64 por palabra, para el filtro de Bloom
+uint64_t ExternalSearch::keyHash(const uint64_t *key, unsigned int words) {
+    uint64_t hash = 0;
+    for (unsigned int w = 0; w < words; w++) {
+        hash += key[w] + 0x9E3779B97F4A7C15ull;
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+        hash ^= hash >> 31;
+    }
+    return hash;
+}
+
+std::string ExternalSearch::layerPath(unsigned int layer) const {
+    return file_prefix + "layer_" + std::to_string(layer) + ".bin";
+}
+
+std::string ExternalSearch::runPath(unsigned int run) const {
+    return file_prefix + "run_" + std::to_string(run) + ".bin";
+}
+
+bool ExternalSearch::openReader(Reader &reader, const std::string &path) {
+    reader.file = std::fopen(path.c_str(), "rb");
+    if (!reader.file) {
+        io_error = true;
+        return false;
+    }
+    reader.buffer = new uint64_t[BLOCK_KEYS * key_words];
+    reader.count = 0;
+    reader.pos = 0;
+    reader.block = NO_BLOCK;
+    return true;
+}
+
+// false si el bloque esta mas alla del final; el lector queda como estaba
+bool ExternalSearch::loadBlock(Reader &reader, size_t block) {
+    long offset =
+        static_cast<long>(block * BLOCK_KEYS * key_words * sizeof(uint64_t));
+    if (std::fseek(reader.file, offset, SEEK_SET) != 0) {
+        return false;
+    }
+    size_t count = std::fread(reader.buffer, key_words * sizeof(uint64_t),
+                              BLOCK_KEYS, reader.file);
+    if (count == 0) {
+        return false;
+    }
+    reader.count = count;
+    reader.pos = 0;
+    reader.block = block;
+    return true;
+}
+
+// nullptr al final del archivo
+const uint64_t *ExternalSearch::peek(Reader &reader) {
+    if (reader.pos == reader.count) {
+        size_t next = reader.block == NO_BLOCK ? 0 : reader.block + 1;
+        if (!loadBlock(reader, next)) {
+            return nullptr;
+        }
+    }
+    return reader.buffer + reader.pos * key_words;
+}
+
+void ExternalSearch::advance(Reader &reader) { reader.pos++; }
+
+void ExternalSearch::closeReader(Reader &reader) {
+    if (reader.file) {
+        std::fclose(reader.file);
+    }
+    delete[] reader.buffer;
+    reader.file = nullptr;
+    reader.buffer = nullptr;
+}
+
+unsigned int ExternalSearch::addLayer() {
+    if (num_layers == layers_capacity) {
+        unsigned int new_capacity = layers_capacity ? layers_capacity * 2 : 16;
+        Layer *new_layers = new Layer[new_capacity];
+        for (unsigned int l = 0; l < num_layers; l++) {
+            new_layers[l] = layers[l];
+        }
+        delete[] layers;
+        layers = new_layers;
+        layers_capacity = new_capacity;
+    }
+    Layer &layer = layers[num_layers];
+    layer.size = 0;
+    layer.fences = nullptr;
+    layer.num_fences = 0;
+    layer.fences_capacity = 0;
+    layer.reader = {nullptr, nullptr, 0, 0, NO_BLOCK};
+    return num_layers++;
+}
+
+void ExternalSearch::addFence(Layer &layer, const uint64_t *key) {
+    if (layer.num_fences == layer.fences_capacity) {
+        size_t new_capacity =
+            layer.fences_capacity ? layer.fences_capacity * 2 : 16;
+        uint64_t *new_fences = new uint64_t[new_capacity * key_words];
+        if (layer.num_fences > 0) {
+            memcpy(new_fences, layer.fences,
+                   layer.num_fences * key_words * sizeof(uint64_t));
+        }
+        delete[] layer.fences;
+        layer.fences = new_fences;
+        layer.fences_capacity = new_capacity;
+    }
+    memcpy(layer.fences + layer.num_fences * key_words, key,
+           key_words * sizeof(uint64_t));
+    layer.num_fences++;
+}
+
+// el directorio solo se borra si quedo vacio
+void ExternalSearch::removeFiles() {
+    for (unsigned int l = 0; l < num_layers; l++) {
+        closeReader(layers[l].reader);
+        delete[] layers[l].fences;
+        std::remove(layerPath(l).c_str());
+    }
+    for (unsigned int r = 0; r < num_runs; r++) {
+        std::remove(runPath(r).c_str());
+    }
+    num_layers = 0;
+    num_runs = 0;
+    run_size = 0;
+    rmdir(work_dir.c_str());
+}
+
+size_t ExternalSearch::reservedBytes() const {
+    size_t bytes = state_pool.reservedBytes() + seen.reservedBytes() +
+                   run_capacity * (key_words * sizeof(uint64_t) +
+                                   sizeof(uint32_t)) +
+                   layers_capacity * sizeof(Layer);
+    for (unsigned int l = 0; l < num_layers; l++) {
+        bytes += layers[l].fences_capacity * key_words * sizeof(uint64_t);
+        if (layers[l].reader.buffer) {
+            bytes += BLOCK_KEYS * key_words * sizeof(uint64_t);
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,255 @@
+#include "../include/FocalSearch.h"
+
+FocalSearch::FocalSearch(State *initial_state, State *target_state,
+                         const unsigned int *capacities,
+                         const Search::Options &options)
+    : encoding(capacities, initial_state->size),
+      zobrist(capacities, initial_state->size),
+      state_pool(initial_state->size, &encoding, &zobrist),
+      open_index(options.table_config), closed_list(options.table_config) {
+    TRACE_SCOPE;
+    this->capacities = capacities;
+    this->target_state = target_state;
+    this->suboptimality = options.suboptimality < 1.0f ? 1.0f
+                                                       : options.suboptimality;
+    this->limits = options.limits;
+    this->pdb = options.use_pdb
+                    ? new PatternDatabase(capacities, target_state->jugs,
+                                          target_state->size,
+                                          options.pdb_cache_dir)
+                    : nullptr;
+    this->start_state =
+        state_pool.allocate(initial_state->jugs, 0, 0, nullptr);
+    this->num_buckets = 64;
+    this->buckets = new FBucket[num_buckets]();
+    this->f_min = 0;
+    this->focal_bound = 0;
+    this->expanded = 0;
+    this->reopened = 0;
+}
+
+// los estados son del pool, las tablas y FOCAL solo se vacian
+FocalSearch::~FocalSearch() {
+    TRACE_SCOPE;
+    focal.clear();
+    open_index.clear();
+    closed_list.clear();
+    for (unsigned int i = 0; i < num_buckets; i++) {
+        delete[] buckets[i].items;
+    }
+    delete[] buckets;
+    delete pdb;
+}
+
+unsigned int FocalSearch::f(const State *state) {
+    return state->depth + state->lower_bound;
+}
+
+// cota admisible para OPEN y peso de calculateHeuristic para FOCAL
+void FocalSearch::evaluate(State *state) {
+    state->lower_bound = state->movesLowerBound(*target_state);
+    if (pdb) {
+        unsigned int pattern_bound = pdb->lookup(state->jugs);
+        state->dead_end = pattern_bound == PatternDatabase::UNREACHABLE;
+        if (pattern_bound > state->lower_bound) {
+            state->lower_bound = pattern_bound;
+        }
+    }
+    state->calculateHeuristic(*target_state);
+}
+
+bool FocalSearch::inOpen(State *state) const {
+    return open_index.lookup(state) == state;
+}
+
+unsigned int FocalSearch::boundFor(unsigned int f_value) const {
+    return static_cast<unsigned int>(f_value * suboptimality + 1e-4f);
+}
+
+size_t FocalSearch::reservedBytes() const {
+    return state_pool.reservedBytes() + open_index.reservedBytes() +
+           closed_list.reservedBytes() + focal.reservedBytes() +
+           num_buckets * sizeof(FBucket);
+}
+
+Search::Path FocalSearch::findPath() {
+    TRACE_SCOPE;
+    evaluate(start_state);
+    if (!start_state->dead_end) {
+        f_min = f(start_state);
+        focal_bound = boundFor(f_min);
+        pushOpen(start_state);
+    }
+
+    Search::Path path = {nullptr, 0, 0, StopReason::COMPLETED};
+    LimitGovernor governor(limits);
+    while (!focal.empty()) {
+        // cortada no hay camino, pero f_min sigue siendo cota del optimo
+        if (governor.exceeded(expanded, state_pool.live_states,
+                              reservedBytes())) {
+            path = {nullptr, 0, f_min, governor.reason};
+            break;
+        }
+        State *current = focal.pop();
+        current->open_handle = nullptr;
+        // f_min antes de sacarlo es cota inferior del optimo
+        unsigned int lower_bound = f_min;
+        removeOpen(current);
+
+        if (current->lower_bound == 0 &&
+            memcmp(current->jugs, target_state->jugs,
+                   current->size * sizeof(unsigned int)) == 0) {
+            path = reconstructPath(current, lower_bound);
+            break;
+        }
+
+        closed_list.insert(current);
+        expanded++;
+
+        unsigned int num_successors = 0;
+        State **successors = current->generateSuccessors(
+            capacities, num_successors, &state_pool);
+        for (unsigned int i = 0; i < num_successors; i++) {
+            State *child = successors[i];
+            evaluate(child);
+            if (child->dead_end) {
+                state_pool.release(child);
+                continue;
+            }
+
+            // los estados cerrados o encolados no se liberan: pueden ser
+            // padres de otros o seguir en un bucket
+            State *closed = closed_list.lookup(child);
+            if (closed) {
+                if (closed->depth <= child->depth) {
+                    state_pool.release(child);
+                    continue;
+                }
+                closed_list.removeState(closed);
+                reopened++;
+            }
+            State *queued = open_index.lookup(child);
+            if (queued) {
+                if (queued->depth <= child->depth) {
+                    state_pool.release(child);
+                    continue;
+                }
+                removeOpen(queued);
+            }
+            pushOpen(child);
+        }
+        delete[] successors;
+
+        refreshFocal();
+    }
+
+    std::cout << "\nSearch statistics:" << std::endl;
+    std::cout << "Expanded states: " << expanded
+              << ", reopened: " << reopened << std::endl;
+    if (path.length > 0) {
+        std::cout << "Bound: " << path.length - 1 << " <= " << suboptimality
+                  << " * optimal, optimal >= " << path.lower_bound
+                  << std::endl;
+    }
+    return path;
+}
+
+void FocalSearch::pushOpen(State *state) {
+    unsigned int f_value = f(state);
+    if (f_value >= num_buckets) {
+        unsigned int new_count = num_buckets;
+        while (new_count <= f_value) {
+            new_count *= 2;
+        }
+        FBucket *bigger = new FBucket[new_count]();
+        memcpy(bigger, buckets, num_buckets * sizeof(FBucket));
+        delete[] buckets;
+        buckets = bigger;
+        num_buckets = new_count;
+    }
+
+    FBucket &bucket = buckets[f_value];
+    if (bucket.count == bucket.capacity) {
+        size_t new_capacity = bucket.capacity ? bucket.capacity * 2 : 16;
+        State **bigger = new State *[new_capacity];
+        if (bucket.items) {
+            memcpy(bigger, bucket.items, bucket.count * sizeof(State *));
+        }
+        delete[] bucket.items;
+        bucket.items = bigger;
+        bucket.capacity = new_capacity;
+    }
+    bucket.items[bucket.count++] = state;
+    bucket.live++;
+    open_index.insert(state);
+
+    // un estado reabierto puede bajar f_min, refreshFocal ajusta la cota
+    if (f_value < f_min) {
+        f_min = f_value;
+    }
+    if (f_value <= focal_bound) {
+        state->open_handle = focal.push(state);
+    }
+}
+
+void FocalSearch::removeOpen(State *state) {
+    open_index.removeState(state);
+    buckets[f(state)].live--;
+    if (state->open_handle) {
+        focal.erase(static_cast<PairingHeap::Handle>(state->open_handle));
+        state->open_handle = nullptr;
+    }
+}
+
+// Mueve f_min al primer bucket con estados validos y ajusta FOCAL a la nueva
+// cota w * f_min: si sube se agregan los buckets que entran, si baja (por un
+// reabierto) se sacan los que quedaron fuera. De paso se compactan los buckets
+// recorridos
+void FocalSearch::refreshFocal() {
+    TRACE_SCOPE;
+    while (f_min < num_buckets && buckets[f_min].live == 0) {
+        f_min++;
+    }
+    if (f_min >= num_buckets) {
+        return;
+    }
+
+    unsigned int new_bound = boundFor(f_min);
+    unsigned int low = std::min(new_bound, focal_bound) + 1;
+    unsigned int high = std::min(std::max(new_bound, focal_bound),
+                                 num_buckets - 1);
+    for (unsigned int f_value = low; f_value <= high; f_value++) {
+        FBucket &bucket = buckets[f_value];
+        size_t kept = 0;
+        for (size_t k = 0; k < bucket.count; k++) {
+            State *state = bucket.items[k];
+            if (!inOpen(state)) {
+                continue;
+            }
+            bucket.items[kept++] = state;
+            if (new_bound > focal_bound && !state->open_handle) {
+                state->open_handle = focal.push(state);
+            } else if (new_bound < focal_bound && state->open_handle) {
+                focal.erase(static_cast<PairingHeap::Handle>(
+                    state->open_handle));
+                state->open_handle = nullptr;
+            }
+        }
+        bucket.count = kept;
+    }
+    focal_bound = new_bound;
+}
+
+Search::Path FocalSearch::reconstructPath(State *goal,
+                                          unsigned int lower_bound) const {
+    unsigned int length = 0;
+    for (State *s = goal; s; s = s->parent) {
+        length++;
+    }
+    State **path_states = new State *[length];
+    unsigned int index = length;
+    for (State *s = goal; s; s = s->parent) {
+        path_states[--index] = s;
+    }
+    return {path_states, length, lower_bound, StopReason::COMPLETED};
+}
@@ -0,0 +1,402 @@
+#include "../include/HDAStarSearch.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+HDAStarSearch::Batch::Batch(unsigned int jug_count) {
+    this->next = nullptr;
+    this->count = 0;
+    this->jugs = new unsigned int[BATCH_SIZE * jug_count];
+}
+
+HDAStarSearch::Batch::~Batch() { delete[] jugs; }
+
+HDAStarSearch::HDAStarSearch(State *initial_state, State *target_state,
+                             const unsigned int *capacities,
+                             unsigned int num_threads,
+                             const SearchLimits &limits)
+    : encoding(capacities, initial_state->size),
+      zobrist(capacities, initial_state->size), governor(limits) {
+    TRACE_SCOPE;
+    this->capacities = capacities;
+    this->target_state = target_state;
+    this->size = initial_state->size;
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    this->num_threads = num_threads;
+    this->workers = new Worker[num_threads];
+    for (unsigned int t = 0; t < num_threads; t++) {
+        Worker &worker = workers[t];
+        worker.state_pool = new StatePool(size, &encoding, &zobrist);
+        worker.inbox.store(nullptr);
+        worker.outgoing = new Batch *[num_threads]();
+        worker.moves = new State::Move[size * (size + 1)];
+        worker.child_jugs = new unsigned int[size];
+        worker.expanded = 0;
+        worker.stored = 0;
+        worker.batches_sent = 0;
+    }
+    this->start_jugs = new unsigned int[size];
+    memcpy(start_jugs, initial_state->jugs, size * sizeof(unsigned int));
+    this->start_hash = zobrist.hashOf(start_jugs);
+    size_t slot_bytes = sizeof(HashTable::Bucket) + sizeof(State *);
+    this->entry_bytes =
+        workers[0].state_pool->record_size + sizeof(PairingHeap::Node) +
+        static_cast<size_t>(slot_bytes / HashTable::MAX_LOAD_FACTOR) + 1;
+    this->incumbent = nullptr;
+    this->incumbent_cost.store(NO_SOLUTION);
+}
+
+HDAStarSearch::~HDAStarSearch() {
+    TRACE_SCOPE;
+    for (unsigned int t = 0; t < num_threads; t++) {
+        Worker &worker = workers[t];
+        discardBatches(t);
+        // los estados son del pool: se sacan de la tabla antes de borrarlo
+        worker.seen.clear();
+        worker.open.clear();
+        delete worker.state_pool;
+        delete[] worker.outgoing;
+        delete[] worker.moves;
+        delete[] worker.child_jugs;
+    }
+    delete[] workers;
+    delete[] start_jugs;
+}
+
+// los bits altos del hash: los bajos ya los usa la HashTable de cada dueno
+unsigned int HDAStarSearch::ownerOf(uint64_t hash) const {
+    return static_cast<unsigned int>((hash >> 40) % num_threads);
+}
+
+unsigned int HDAStarSearch::weightOf(unsigned int f, unsigned int g) const {
+    g = std::min(g, Search::DEPTH_MASK);
+    return (f << Search::DEPTH_BITS) | (Search::DEPTH_MASK - g);
+}
+
+// Si se corta por un tope, lo que quedo sin expandir (heaps y bandejas)
+// contiene un estado del camino optimo, asi que el menor f pendiente es cota
+Search::Path HDAStarSearch::findPath() {
+    TRACE_SCOPE;
+    governor = LimitGovernor(governor.limits);
+    for (unsigned int t = 0; t < num_threads; t++) {
+        Worker &worker = workers[t];
+        discardBatches(t);
+        worker.seen.clear();
+        worker.open.clear();
+        worker.state_pool->clear();
+        worker.expanded = 0;
+        worker.stored = 0;
+        worker.batches_sent = 0;
+    }
+    incumbent = nullptr;
+    incumbent_cost.store(NO_SOLUTION);
+    total_expanded.store(0);
+    total_stored.store(0);
+    stop.store(false);
+    work.store(num_threads);
+
+    receive(ownerOf(start_hash), start_jugs, 0, start_hash, nullptr);
+    std::thread *threads = new std::thread[num_threads - 1];
+    for (unsigned int t = 1; t < num_threads; t++) {
+        threads[t - 1] = std::thread(&HDAStarSearch::run, this, t);
+    }
+    run(0);
+    for (unsigned int t = 1; t < num_threads; t++) {
+        threads[t - 1].join();
+    }
+    delete[] threads;
+
+    Search::Path path = {nullptr, 0, 0, StopReason::COMPLETED};
+    if (incumbent) {
+        path = buildPath();
+    }
+    if (stop.load()) {
+        unsigned int bound = pendingBound();
+        if (incumbent) {
+            path.lower_bound = std::min(path.lower_bound, bound);
+        } else {
+            path.lower_bound = bound == NO_SOLUTION ? 0 : bound;
+        }
+        path.stop_reason = governor.reason;
+    }
+
+    size_t expanded = 0;
+    size_t stored = 0;
+    size_t batches_sent = 0;
+    std::cout << "\nSearch statistics:" << std::endl;
+    std::cout << "Expanded per thread:";
+    for (unsigned int t = 0; t < num_threads; t++) {
+        std::cout << " " << workers[t].expanded;
+        expanded += workers[t].expanded;
+        stored += workers[t].stored;
+        batches_sent += workers[t].batches_sent;
+    }
+    std::cout << std::endl;
+    std::cout << "Expanded states: " << expanded << ", stored: " << stored
+              << ", batches sent: " << batches_sent << ", threads: "
+              << num_threads << std::endl;
+    return path;
+}
+
+// Ciclo de cada hilo: vaciar la bandeja, expandir el mejor propio y, sin nada
+// que hacer, mandar lo pendiente y quedar ocioso hasta que llegue un lote o
+// work llegue a 0. Un hilo ocioso que recibe lotes vuelve a contar como
+// activo antes de descontarlos, asi work no pasa por 0 mientras haya trabajo
+void HDAStarSearch::run(unsigned int id) {
+    TRACE_SCOPE;
+    Worker &worker = workers[id];
+    bool active = true;
+    unsigned int since_flush = 0;
+    size_t published_expanded = 0;
+    size_t published_stored = 0;
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        // lo propio sin publicar tambien cuenta
+        size_t stored =
+            total_stored.load() + worker.stored - published_stored;
+        if (id == 0 &&
+            governor.exceeded(total_expanded.load() + worker.expanded -
+                                  published_expanded,
+                              stored, stored * entry_bytes)) {
+            stop.store(true);
+            break;
+        }
+        if (worker.inbox.load(std::memory_order_relaxed)) {
+            if (!active) {
+                work.fetch_add(1);
+                active = true;
+            }
+            work.fetch_sub(drainInbox(id));
+        }
+
+        State *state = worker.open.pop();
+        if (state) {
+            state->open_handle = nullptr;
+            unsigned int f = state->weight >> Search::DEPTH_BITS;
+            // incumbent_cost pudo bajar desde que se encolo
+            if (f >= incumbent_cost.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            if (state->lower_bound == 0) {
+                offerSolution(state);
+                continue;
+            }
+            expand(id, state);
+            if (++since_flush == FLUSH_INTERVAL) {
+                since_flush = 0;
+                flushAll(id);
+                total_expanded.fetch_add(worker.expanded - published_expanded);
+                total_stored.fetch_add(worker.stored - published_stored);
+                published_expanded = worker.expanded;
+                published_stored = worker.stored;
+            }
+            continue;
+        }
+
+        if (active) {
+            // primero se mandan los lotes, que cuentan en work
+            flushAll(id);
+            total_expanded.fetch_add(worker.expanded - published_expanded);
+            total_stored.fetch_add(worker.stored - published_stored);
+            published_expanded = worker.expanded;
+            published_stored = worker.stored;
+            work.fetch_sub(1);
+            active = false;
+        }
+        if (work.load() == 0) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    // cortado por un tope: lo pendiente queda en las bandejas para la cota
+    flushAll(id);
+}
+
+void HDAStarSearch::receive(unsigned int id, const unsigned int *jugs,
+                            unsigned int depth, uint64_t hash,
+                            State *parent) {
+    Worker &worker = workers[id];
+    State *state = worker.state_pool->allocate(jugs, depth, 0, parent, hash);
+    State *known = worker.seen.lookup(state);
+    if (known) {
+        worker.state_pool->release(state);
+        if (known->depth <= depth) {
+            return;
+        }
+        // camino mas corto a un estado ya visto: se corrige en su lugar y
+        // se vuelve a abrir si ya estaba cerrado
+        unsigned int f = depth + known->lower_bound;
+        known->depth = depth;
+        known->parent = parent;
+        known->weight = weightOf(f, depth);
+        if (known->open_handle) {
+            worker.open.decreaseKey(
+                static_cast<PairingHeap::Handle>(known->open_handle),
+                known->weight);
+        } else if (f < incumbent_cost.load(std::memory_order_relaxed)) {
+            known->open_handle = worker.open.push(known);
+        }
+        return;
+    }
+    state->lower_bound = state->movesLowerBound(*target_state);
+    unsigned int f = depth + state->lower_bound;
+    if (f >= incumbent_cost.load(std::memory_order_relaxed)) {
+        worker.state_pool->release(state);
+        return;
+    }
+    state->weight = weightOf(f, depth);
+    worker.seen.insert(state);
+    worker.stored++;
+    state->open_handle = worker.open.push(state);
+}
+
+long HDAStarSearch::drainInbox(unsigned int id) {
+    TRACE_SCOPE;
+    Worker &worker = workers[id];
+    Batch *batch = worker.inbox.exchange(nullptr, std::memory_order_acquire);
+    long received = 0;
+    while (batch) {
+        for (unsigned int k = 0; k < batch->count; k++) {
+            receive(id, batch->jugs + k * size, batch->depths[k],
+                    batch->hashes[k], batch->parents[k]);
+        }
+        Batch *next = batch->next;
+        delete batch;
+        batch = next;
+        received++;
+    }
+    return received;
+}
+
+// los hijos con f >= la solucion actual ni se crean; la cota del hijo sale de
+// la del padre con mismatchDelta
+void HDAStarSearch::expand(unsigned int id, State *state) {
+    Worker &worker = workers[id];
+    unsigned int num_moves = state->generateMoves(capacities, worker.moves);
+    unsigned int mismatched = state->mismatchedJugs(*target_state);
+    unsigned int depth = state->depth + 1;
+    unsigned int bound = incumbent_cost.load(std::memory_order_relaxed);
+    unsigned int *child_jugs = worker.child_jugs;
+    memcpy(child_jugs, state->jugs, size * sizeof(unsigned int));
+    worker.expanded++;
+
+    for (unsigned int m = 0; m < num_moves; m++) {
+        const State::Move &move = worker.moves[m];
+        unsigned int child_mismatched =
+            mismatched + state->mismatchDelta(move, capacities, *target_state);
+        if (depth + (child_mismatched + 1) / 2 >= bound) {
+            continue;
+        }
+        state->applyMove(move, capacities, child_jugs);
+        uint64_t hash = zobrist.childHash(state->hash, state->jugs,
+                                          child_jugs, move.from, move.to);
+        unsigned int owner = ownerOf(hash);
+        if (owner == id) {
+            receive(id, child_jugs, depth, hash, state);
+        } else {
+            Batch *&batch = worker.outgoing[owner];
+            if (!batch) {
+                batch = new Batch(size);
+            }
+            unsigned int k = batch->count++;
+            batch->parents[k] = state;
+            batch->depths[k] = depth;
+            batch->hashes[k] = hash;
+            memcpy(batch->jugs + k * size, child_jugs,
+                   size * sizeof(unsigned int));
+            if (batch->count == BATCH_SIZE) {
+                send(id, owner);
+            }
+        }
+        child_jugs[move.from] = state->jugs[move.from];
+        child_jugs[move.to] = state->jugs[move.to];
+    }
+}
+
+// push de una pila de Treiber: el lote cuenta en work antes de ser visible
+void HDAStarSearch::send(unsigned int from, unsigned int to) {
+    Batch *batch = workers[from].outgoing[to];
+    if (!batch) {
+        return;
+    }
+    workers[from].outgoing[to] = nullptr;
+    workers[from].batches_sent++;
+    work.fetch_add(1);
+    std::atomic<Batch *> &inbox = workers[to].inbox;
+    batch->next = inbox.load(std::memory_order_relaxed);
+    while (!inbox.compare_exchange_weak(batch->next, batch,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+    }
+}
+
+void HDAStarSearch::flushAll(unsigned int id) {
+    for (unsigned int t = 0; t < num_threads; t++) {
+        send(id, t);
+    }
+}
+
+void HDAStarSearch::offerSolution(State *goal) {
+    std::lock_guard<std::mutex> lock(incumbent_mutex);
+    if (goal->depth < incumbent_cost.load()) {
+        incumbent = goal;
+        incumbent_cost.store(goal->depth);
+    }
+}
+
+unsigned int HDAStarSearch::pendingBound() {
+    unsigned int bound = incumbent_cost.load();
+    for (unsigned int t = 0; t < num_threads; t++) {
+        Worker &worker = workers[t];
+        if (!worker.open.empty()) {
+            bound = std::min(bound,
+                             worker.open.peek()->weight >> Search::DEPTH_BITS);
+        }
+        Batch *batch = worker.inbox.load();
+        for (; batch; batch = batch->next) {
+            for (unsigned int k = 0; k < batch->count; k++) {
+                const unsigned int *jugs = batch->jugs + k * size;
+                unsigned int mismatched = 0;
+                for (unsigned int i = 0; i < size; i++) {
+                    if (jugs[i] != target_state->jugs[i]) {
+                        mismatched++;
+                    }
+                }
+                bound = std::min(bound,
+                                 batch->depths[k] + (mismatched + 1) / 2);
+            }
+        }
+    }
+    return bound;
+}
+
+void HDAStarSearch::discardBatches(unsigned int id) {
+    Worker &worker = workers[id];
+    Batch *batch = worker.inbox.exchange(nullptr);
+    while (batch) {
+        Batch *next = batch->next;
+        delete batch;
+        batch = next;
+    }
+    for (unsigned int t = 0; t < num_threads; t++) {
+        delete worker.outgoing[t];
+        worker.outgoing[t] = nullptr;
+    }
+}
+
+// los padres pueden estar en los pools de otros hilos
+Search::Path HDAStarSearch::buildPath() const {
+    TRACE_SCOPE;
+    unsigned int length = 0;
+    for (State *state = incumbent; state; state = state->parent) {
+        length++;
+    }
+    State **path_states = new State *[length];
+    State *state = incumbent;
+    for (unsigned int i = length; i-- > 0; state = state->parent) {
+        path_states[i] = state;
+    }
+    return {path_states, length, length - 1, StopReason::COMPLETED};
+}
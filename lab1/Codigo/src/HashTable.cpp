@@ -1,204 +1,355 @@
 #include "../include/HashTable.h"
 #include <cassert>
 
+HashTable::Config::Config() {
+    this->initial_capacity = INITIAL_SIZE;
+    this->max_load_factor = MAX_LOAD_FACTOR;
+    this->max_psl = MAX_PSL;
+    this->migrate_step = MIGRATE_STEP;
+}
+
 HashTable::Bucket::Bucket() {
-    this->state = nullptr;
+    this->hash = 0;
     this->psl = 0;
+    this->hash_high = 0;
     this->occupied = false;
 }
 
-HashTable::HashTable() {
+HashTable::Table::Table() {
+    this->buckets = nullptr;
+    this->states = nullptr;
+    this->capacity = 0;
+    this->size = 0;
+}
+
+void HashTable::Table::allocate(size_t capacity) {
+    this->capacity = capacity;
     this->size = 0;
-    this->capacity = INITIAL_SIZE;
     this->buckets = new Bucket[capacity]();
+    this->states = new State *[capacity]();
+}
+
+void HashTable::Table::release() {
+    delete[] buckets;
+    delete[] states;
+    buckets = nullptr;
+    states = nullptr;
+    capacity = 0;
+    size = 0;
+}
+
+HashTable::HashTable(const Config &config) {
+    this->config = config;
+    // la capacidad siempre es potencia de 2
+    size_t capacity = 16;
+    while (capacity < config.initial_capacity) {
+        capacity <<= 1;
+    }
+    this->table.allocate(capacity);
+    this->migrate_pos = 0;
+    this->size = 0;
 }
 
 HashTable::~HashTable() {
-    if (buckets) {
+    if (table.buckets) {
         cleanup();
-        delete[] buckets;
-        buckets = nullptr;
+        table.release();
+        old_table.release();
     }
 }
 
+bool HashTable::migrating() const { return old_table.buckets != nullptr; }
+
+size_t HashTable::reservedBytes() const {
+    return (table.capacity + old_table.capacity) *
+           (sizeof(Bucket) + sizeof(State *));
+}
+
 bool HashTable::insert(State *state) {
-    if (!state || !buckets)
+    if (!state || !table.buckets)
         return false;
 
+    uint64_t hash = computeHash(state);
+    if (migrating()) {
+        migrateStep(config.migrate_step);
+        if (migrating() && find(old_table, state, hash) >= 0) {
+            return false;
+        }
+    }
+    if (find(table, state, hash) >= 0) {
+        return false;
+    }
+
     if (shouldResize()) {
-        resize();
+        startResize();
     }
 
-    unsigned int hash = computeHash(state);
-    unsigned int pos = hash & (capacity - 1);
-    unsigned int psl = 0;
+    insertHashed(state, hash);
+    return true;
+}
+
+// Robin Hood sin revisar duplicados. Si el sondeo se alarga demasiado con la
+// tabla razonablemente llena se empieza a crecer y lo que se lleva en la mano
+// sigue en la tabla nueva; si no, se sigue sondeando
+void HashTable::insertHashed(State *state, uint64_t hash) {
+    size_t mask = table.capacity - 1;
+    size_t pos = hash & mask;
 
     State *current_state = state;
-    unsigned int current_psl = psl;
+    uint64_t current_hash = hash;
+    unsigned int current_psl = 0;
 
     while (true) {
-        if (!buckets[pos].occupied) {
-            buckets[pos].state = current_state;
-            buckets[pos].psl = current_psl;
-            buckets[pos].occupied = true;
+        Bucket &bucket = table.buckets[pos];
+        if (!bucket.occupied) {
+            bucket.hash = static_cast<unsigned int>(current_hash);
+            bucket.hash_high = static_cast<unsigned char>(current_hash >> 32);
+            bucket.psl = static_cast<unsigned short>(current_psl);
+            bucket.occupied = true;
+            table.states[pos] = current_state;
+            table.size++;
             size++;
-            return true;
-        }
-        if (buckets[pos].state && buckets[pos].state->equals(state)) {
-            return false;
+            return;
         }
 
         // Robin Hood Hashing
-        if (current_psl > buckets[pos].psl) {
-            std::swap(current_state, buckets[pos].state);
-            std::swap(current_psl, buckets[pos].psl);
+        if (current_psl > bucket.psl) {
+            uint64_t displaced_hash = storedHash(bucket);
+            unsigned int displaced_psl = bucket.psl;
+            bucket.hash = static_cast<unsigned int>(current_hash);
+            bucket.hash_high = static_cast<unsigned char>(current_hash >> 32);
+            bucket.psl = static_cast<unsigned short>(current_psl);
+            current_hash = displaced_hash;
+            current_psl = displaced_psl;
+            std::swap(current_state, table.states[pos]);
         }
 
-        pos = (pos + 1) & (capacity - 1);
+        pos = (pos + 1) & mask;
         current_psl++;
 
-        if (current_psl >= 8) {
-            resize();
-            return insert(current_state);
+        if (current_psl >= config.max_psl && !migrating() &&
+            static_cast<float>(size) / table.capacity >=
+                config.max_load_factor * 0.5f) {
+            startResize();
+            mask = table.capacity - 1;
+            pos = current_hash & mask;
+            current_psl = 0;
         }
     }
 }
 
 bool HashTable::contains(const State *state) const {
-    if (!state || !buckets)
+    if (!state || !table.buckets)
         return false;
 
-    unsigned int hash = computeHash(state);
-    unsigned int pos = hash & (capacity - 1);
-    unsigned int psl = 0;
+    uint64_t hash = computeHash(state);
+    if (find(table, state, hash) >= 0) {
+        return true;
+    }
+    return migrating() && find(old_table, state, hash) >= 0;
+}
 
-    while (true) {
-        if (!buckets[pos].occupied) {
-            return false;
+// devuelve el estado guardado igual a state, o nullptr
+State *HashTable::lookup(const State *state) const {
+    if (!state || !table.buckets)
+        return nullptr;
+
+    uint64_t hash = computeHash(state);
+    long long pos = find(table, state, hash);
+    if (pos >= 0) {
+        return table.states[pos];
+    }
+    if (migrating()) {
+        pos = find(old_table, state, hash);
+        if (pos >= 0) {
+            return old_table.states[pos];
         }
+    }
+    return nullptr;
+}
+
+// cambia el estado guardado igual a state por state. Tienen el mismo hash, asi
+// que basta con cambiar el puntero del slot
+bool HashTable::replace(State *state) {
+    if (!state || !table.buckets)
+        return false;
 
-        if (buckets[pos].state && buckets[pos].state->equals(state)) {
+    uint64_t hash = computeHash(state);
+    long long pos = find(table, state, hash);
+    if (pos >= 0) {
+        table.states[pos] = state;
+        return true;
+    }
+    if (migrating()) {
+        pos = find(old_table, state, hash);
+        if (pos >= 0) {
+            old_table.states[pos] = state;
             return true;
         }
+    }
+    return false;
+}
 
-        if (psl > buckets[pos].psl) {
-            return false;
+// el sondeo solo lee la metadata, el State se compara cuando la huella
+// coincide
+long long HashTable::find(const Table &t, const State *state,
+                          uint64_t hash) {
+    size_t mask = t.capacity - 1;
+    size_t pos = hash & mask;
+    unsigned int fingerprint = static_cast<unsigned int>(hash);
+    unsigned char fingerprint_high = static_cast<unsigned char>(hash >> 32);
+    size_t psl = 0;
+
+    while (true) {
+        const Bucket &bucket = t.buckets[pos];
+        if (!bucket.occupied || psl > bucket.psl) {
+            return -1;
+        }
+
+        if (bucket.hash == fingerprint &&
+            bucket.hash_high == fingerprint_high &&
+            t.states[pos]->equals(state)) {
+            return static_cast<long long>(pos);
         }
 
-        pos = (pos + 1) & (capacity - 1);
+        pos = (pos + 1) & mask;
         psl++;
 
-        if (psl >= capacity) {
-            return false;
+        if (psl >= t.capacity) {
+            return -1;
         }
     }
 }
 
 void HashTable::cleanup() {
-    if (!buckets)
-        return;
-
-    for (unsigned int i = 0; i < capacity; i++) {
-        if (buckets[i].occupied && buckets[i].state) {
-            delete buckets[i].state;
-            buckets[i].state = nullptr;
-            buckets[i].occupied = false;
-            buckets[i].psl = 0;
+    Table *tables[2] = {&table, &old_table};
+    for (Table *t : tables) {
+        for (size_t i = 0; i < t->capacity; i++) {
+            if (t->buckets[i].occupied && t->states[i]) {
+                delete t->states[i];
+            }
         }
     }
+    clear();
+}
+
+// olvida las entradas sin liberar los estados, para cuando los estados son de
+// un StatePool
+void HashTable::clear() {
+    if (!table.buckets)
+        return;
+    old_table.release();
+    migrate_pos = 0;
+    for (size_t i = 0; i < table.capacity; i++) {
+        table.states[i] = nullptr;
+        table.buckets[i] = Bucket();
+    }
+    table.size = 0;
     size = 0;
 }
 
 void HashTable::removeState(State *state) {
-    if (!state || !buckets)
+    if (!state || !table.buckets)
         return;
 
-    unsigned int hash = computeHash(state);
-    unsigned int pos = hash & (capacity - 1);
-    unsigned int psl = 0;
-
-    while (true) {
-        if (!buckets[pos].occupied) {
-            return;
-        }
-
-        if (buckets[pos].state && buckets[pos].state->equals(state)) {
-            // Found the state - perform backward-shift deletion
-            unsigned int current = pos;
-            unsigned int next = (current + 1) & (capacity - 1);
-
-            while (buckets[next].occupied && buckets[next].psl > 0) {
-                buckets[current] = buckets[next];
-                buckets[current].psl--;
-                current = next;
-                next = (current + 1) & (capacity - 1);
-            }
-
-            buckets[current].occupied = false;
-            buckets[current].state = nullptr;
-            buckets[current].psl = 0;
+    uint64_t hash = computeHash(state);
+    if (migrating()) {
+        migrateStep(config.migrate_step);
+    }
+    long long pos = find(table, state, hash);
+    if (pos >= 0) {
+        eraseAt(table, static_cast<size_t>(pos));
+        size--;
+        return;
+    }
+    if (migrating()) {
+        pos = find(old_table, state, hash);
+        if (pos >= 0) {
+            eraseAt(old_table, static_cast<size_t>(pos));
             size--;
-            return;
         }
+    }
+}
 
-        if (psl > buckets[pos].psl) {
-            return;
-        }
+// backward-shift deletion
+void HashTable::eraseAt(Table &t, size_t pos) {
+    size_t mask = t.capacity - 1;
+    size_t current = pos;
+    size_t next = (current + 1) & mask;
+
+    while (t.buckets[next].occupied && t.buckets[next].psl > 0) {
+        t.buckets[current] = t.buckets[next];
+        t.buckets[current].psl--;
+        t.states[current] = t.states[next];
+        current = next;
+        next = (current + 1) & mask;
+    }
 
-        pos = (pos + 1) & (capacity - 1);
-        psl++;
+    t.buckets[current] = Bucket();
+    t.states[current] = nullptr;
+    t.size--;
+}
 
-        if (psl >= capacity) {
-            return;
-        }
-    }
+uint64_t HashTable::storedHash(const Bucket &bucket) {
+    return static_cast<uint64_t>(bucket.hash) |
+           (static_cast<uint64_t>(bucket.hash_high) << 32);
 }
 
-unsigned int HashTable::computeHash(const State *state) const {
+// hash de 64 bits para poder pasar de 2^32 slots. Los estados de un pool con
+// ZobristHash ya lo traen; los demas lo calculan con las mismas llaves
+uint64_t HashTable::computeHash(const State *state) {
     if (!state || !state->jugs)
         return 0;
-
-    unsigned int h = PRIME1;
-
-    for (unsigned int i = 0; i < state->size; i++) {
-        unsigned int k = state->jugs[i];
-
-        k *= PRIME2;
-        k = (k << 23) | (k >> 9);
-        k *= PRIME3;
-
-        h ^= k;
-        h = (h << 17) | (h >> 15);
-        h += h << 3;
+    if (state->hashed) {
+        return state->hash;
     }
-
-    h ^= h >> 16;
-    h *= PRIME2;
-    h ^= h >> 13;
-    h *= PRIME3;
-    h ^= h >> 16;
-
-    return h;
+    return ZobristHash::computeFrom(state->jugs, state->size);
 }
 
 bool HashTable::shouldResize() const {
-    return (static_cast<float>(size) / capacity) >= MAX_LOAD_FACTOR;
+    return (static_cast<float>(size + 1) / table.capacity) >=
+           config.max_load_factor;
 }
 
-void HashTable::resize() {
-    if (!buckets)
-        return;
+// la tabla actual pasa a ser la vieja y se reserva una del doble. Si todavia
+// quedaba una migracion pendiente se termina antes
+void HashTable::startResize() {
+    if (migrating()) {
+        finishResize();
+    }
+    old_table = table;
+    table = Table();
+    table.allocate(old_table.capacity * 2);
+    migrate_pos = 0;
+}
 
-    unsigned int old_capacity = capacity;
-    Bucket *old_buckets = buckets;
-    capacity *= 2;
-    buckets = new Bucket[capacity]();
-    size = 0;
-    for (unsigned int i = 0; i < old_capacity; i++) {
-        if (old_buckets[i].occupied && old_buckets[i].state) {
-            insert(old_buckets[i].state);
+// mueve a lo mas max_buckets buckets de la tabla vieja. Se saca la entrada
+// con backward-shift, asi la tabla vieja sigue siendo un Robin Hood valido y
+// todo lo que queda antes de migrate_pos esta vacio
+void HashTable::migrateStep(size_t max_buckets) {
+    for (size_t done = 0; done < max_buckets; done++) {
+        if (old_table.size == 0) {
+            old_table.release();
+            migrate_pos = 0;
+            return;
+        }
+        if (migrate_pos >= old_table.capacity) {
+            migrate_pos = 0;
+        }
+        if (!old_table.buckets[migrate_pos].occupied) {
+            migrate_pos++;
+            continue;
         }
+        State *state = old_table.states[migrate_pos];
+        uint64_t hash = storedHash(old_table.buckets[migrate_pos]);
+        eraseAt(old_table, migrate_pos);
+        size--;
+        insertHashed(state, hash);
     }
+}
 
-    delete[] old_buckets;
+void HashTable::finishResize() {
+    while (migrating()) {
+        migrateStep(old_table.capacity);
+    }
 }
@@ -1,12 +1,21 @@
 #include "../include/Heap.h"
+#include <cstring>
+#include <new>
 
 PairingHeap::PairingHeap() {
     TRACE_SCOPE;
     this->root = nullptr;
     this->size = 0;
+    this->slabs_capacity = INITIAL_SLABS;
+    this->slabs = new Node *[slabs_capacity];
+    this->num_slabs = 0;
+    this->slabs_in_use = 0;
+    this->used_in_slab = NODES_PER_SLAB;
+    this->free_nodes = nullptr;
 }
 PairingHeap::Node::Node(State *s) {
     this->state = s;
+    this->key = s ? s->weight : 0;
     this->leftChild = nullptr;
     this->nextSibling = nullptr;
     this->prev = nullptr;
@@ -14,45 +23,40 @@ PairingHeap::Node::Node(State *s) {
 PairingHeap::~PairingHeap() {
     TRACE_SCOPE;
     clear();
+    for (unsigned int i = 0; i < num_slabs; i++) {
+        ::operator delete(slabs[i]);
+    }
+    delete[] slabs;
 }
 
-bool PairingHeap::hasHigherPriority(const State *a, const State *b) {
-    return a->weight < b->weight;
+bool PairingHeap::hasHigherPriority(const Node *a, const Node *b) {
+    return a->key < b->key;
 }
-void PairingHeap::push(State *state) {
+
+PairingHeap::Handle PairingHeap::push(State *state) {
     TRACE_SCOPE;
-    Node *newNode = new Node(state);
-    if (!root) {
-        root = newNode;
-    } else {
-        root = merge(root, newNode);
-    }
+    Node *newNode = allocateNode(state);
+    root = merge(root, newNode);
     size++;
     TRACE_PLOT("Heap/Stats/Size", static_cast<int64_t>(size));
     TRACE_PLOT("Heap/Operations/Push", static_cast<int64_t>(1));
     TRACE_PLOT("Heap/Values/Current", static_cast<int64_t>(state->weight));
     TRACE_PLOT("Heap/Stats/MaxDepth", static_cast<int64_t>(state->depth));
+    return newNode;
 }
 
 State *PairingHeap::pop() {
     TRACE_SCOPE;
-    TRACE_PLOT("Heap/Values/Popped", static_cast<int64_t>(root->state->weight));
     if (!root) {
         return nullptr;
     }
+    TRACE_PLOT("Heap/Values/Popped", static_cast<int64_t>(root->key));
 
     Node *oldRoot = root;
     State *result = oldRoot->state;
-    if (root->leftChild) {
-        root = mergePairs(root->leftChild);
-        if (root) {
-            root->prev = nullptr;
-        }
-    } else {
-        root = nullptr;
-    }
+    root = mergePairs(root->leftChild);
 
-    delete oldRoot;
+    releaseNode(oldRoot);
     size--;
     return result;
 }
@@ -62,11 +66,53 @@ State *PairingHeap::peek() const {
     return root ? root->state : nullptr;
 }
 
+// el nodo se corta con su subarbol y se vuelve a juntar con la raiz. Si la
+// llave sube, sus hijos quedan en el heap y el nodo vuelve solo; en ambos
+// casos es el mismo nodo, asi que el handle sigue valido
+void PairingHeap::decreaseKey(Handle node, unsigned int key) {
+    TRACE_SCOPE;
+    if (key > node->key) {
+        Node *children = mergePairs(node->leftChild);
+        node->leftChild = nullptr;
+        if (node == root) {
+            root = children;
+        } else {
+            detach(node);
+            root = merge(root, children);
+        }
+        node->key = key;
+        root = merge(root, node);
+        return;
+    }
+    node->key = key;
+    if (node == root) {
+        return;
+    }
+    detach(node);
+    root = merge(root, node);
+}
+
+void PairingHeap::erase(Handle node) {
+    TRACE_SCOPE;
+    if (node == root) {
+        pop();
+        return;
+    }
+    detach(node);
+    root = merge(root, mergePairs(node->leftChild));
+    releaseNode(node);
+    size--;
+}
+
+// no hace falta recorrer el arbol: todos los nodos viven en los slabs, que se
+// quedan reservados para reutilizarse
 void PairingHeap::clear() {
     TRACE_SCOPE;
-    deleteTree(root);
     root = nullptr;
     size = 0;
+    slabs_in_use = 0;
+    used_in_slab = NODES_PER_SLAB;
+    free_nodes = nullptr;
     TRACE_PLOT("Heap/Stats/Size", static_cast<int64_t>(0));
 }
 
@@ -74,6 +120,11 @@ bool PairingHeap::empty() const {
     TRACE_SCOPE;
     return root == nullptr;
 }
+
+size_t PairingHeap::reservedBytes() const {
+    return static_cast<size_t>(num_slabs) * NODES_PER_SLAB * sizeof(Node) +
+           slabs_capacity * sizeof(Node *);
+}
 PairingHeap::Node *PairingHeap::merge(Node *h1, Node *h2) {
     TRACE_SCOPE;
     if (!h1)
@@ -82,7 +133,7 @@ PairingHeap::Node *PairingHeap::merge(Node *h1, Node *h2) {
         return h1;
 
     // Ensure h1 has higher priority
-    if (!hasHigherPriority(h1->state, h2->state)) {
+    if (!hasHigherPriority(h1, h2)) {
         Node *temp = h1;
         h1 = h2;
         h2 = temp;
@@ -90,49 +141,104 @@ PairingHeap::Node *PairingHeap::merge(Node *h1, Node *h2) {
 
     // Make h2 the leftmost child of h1
     h2->nextSibling = h1->leftChild;
+    if (h1->leftChild) {
+        h1->leftChild->prev = h2;
+    }
     h2->prev = h1;
     h1->leftChild = h2;
 
     return h1;
 }
 
-// Helper function to merge a list of siblings in pairs
+// Two-pass iterativo: la primera pasada junta pares de izquierda a derecha y
+// deja los resultados en una pila enlazada por nextSibling, la segunda los
+// junta de derecha a izquierda. No usa la pila de llamadas aunque haya
+// millones de hermanos
 PairingHeap::Node *PairingHeap::mergePairs(Node *firstSibling) {
     TRACE_SCOPE_NAMED("PairingHeap_mergePairs");
-    if (!firstSibling || !firstSibling->nextSibling) {
-        return firstSibling;
+    if (!firstSibling) {
+        return nullptr;
     }
 
-    // First pass: merge adjacent pairs
-    Node *first = firstSibling;
-    Node *second = first->nextSibling;
-    Node *rest = second->nextSibling;
-
-    first->nextSibling = nullptr;
-    first->prev = nullptr;
-    second->nextSibling = nullptr;
-    second->prev = nullptr;
-
-    Node *merged = merge(first, second);
-
-    if (!rest) {
-        return merged;
+    Node *pairs = nullptr;
+    Node *current = firstSibling;
+    while (current) {
+        Node *first = current;
+        Node *second = first->nextSibling;
+        current = second ? second->nextSibling : nullptr;
+
+        first->nextSibling = nullptr;
+        first->prev = nullptr;
+        Node *merged = first;
+        if (second) {
+            second->nextSibling = nullptr;
+            second->prev = nullptr;
+            merged = merge(first, second);
+        }
+        merged->nextSibling = pairs;
+        pairs = merged;
     }
 
-    Node *temp = mergePairs(rest);
-    return merge(merged, temp);
+    Node *result = pairs;
+    pairs = pairs->nextSibling;
+    result->nextSibling = nullptr;
+    while (pairs) {
+        Node *next = pairs->nextSibling;
+        pairs->nextSibling = nullptr;
+        result = merge(pairs, result);
+        pairs = next;
+    }
+    result->prev = nullptr;
+    return result;
 }
 
-void PairingHeap::deleteTree(Node *node) {
-    TRACE_SCOPE;
-    if (!node)
-        return;
+// saca el subarbol del nodo de la lista de hermanos donde esta
+void PairingHeap::detach(Node *node) {
+    if (node->prev->leftChild == node) {
+        node->prev->leftChild = node->nextSibling;
+    } else {
+        node->prev->nextSibling = node->nextSibling;
+    }
     if (node->nextSibling) {
-        deleteTree(node->nextSibling);
+        node->nextSibling->prev = node->prev;
     }
-    if (node->leftChild) {
-        deleteTree(node->leftChild);
+    node->prev = nullptr;
+    node->nextSibling = nullptr;
+}
+
+PairingHeap::Node *PairingHeap::allocateNode(State *state) {
+    Node *node;
+    if (free_nodes) {
+        node = free_nodes;
+        free_nodes = free_nodes->nextSibling;
+    } else {
+        if (used_in_slab == NODES_PER_SLAB) {
+            if (slabs_in_use == num_slabs) {
+                addSlab();
+            }
+            slabs_in_use++;
+            used_in_slab = 0;
+        }
+        node = slabs[slabs_in_use - 1] + used_in_slab;
+        used_in_slab++;
     }
+    return new (node) Node(state);
+}
 
-    delete node;
+// el nodo vuelve a la free list, se usa nextSibling como enlace
+void PairingHeap::releaseNode(Node *node) {
+    node->nextSibling = free_nodes;
+    free_nodes = node;
+}
+
+void PairingHeap::addSlab() {
+    if (num_slabs == slabs_capacity) {
+        Node **bigger = new Node *[slabs_capacity * 2];
+        memcpy(bigger, slabs, num_slabs * sizeof(Node *));
+        delete[] slabs;
+        slabs = bigger;
+        slabs_capacity *= 2;
+    }
+    slabs[num_slabs++] = static_cast<Node *>(
+        ::operator new(sizeof(Node) * NODES_PER_SLAB));
 }
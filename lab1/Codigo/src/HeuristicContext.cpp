@@ -0,0 +1,195 @@
+#include "../include/HeuristicContext.h"
+#include <algorithm>
+
+// std::min la toma por referencia, en C++11 necesita definicion
+constexpr unsigned int HeuristicContext::SEGMENT_SIZE;
+
+HeuristicContext::HeuristicContext(const State &target_state,
+                                   const unsigned int *capacities) {
+    this->capacities = capacities;
+    this->target = target_state.jugs;
+    this->size = target_state.size;
+    this->num_segments = (size + SEGMENT_SIZE - 1) / SEGMENT_SIZE;
+    this->segment_max = new unsigned int[num_segments]();
+    this->segment_length = new unsigned int[num_segments];
+    for (unsigned int s = 0; s < num_segments; s++) {
+        segment_length[s] = std::min(SEGMENT_SIZE, size - s * SEGMENT_SIZE);
+    }
+    for (unsigned int i = 0; i < size; i++) {
+        unsigned int segment = segmentOf(i);
+        segment_max[segment] = std::max(segment_max[segment], target[i]);
+    }
+    this->parent = nullptr;
+    this->jugs = new unsigned int[size];
+    this->segment_matches = new unsigned int[num_segments]();
+    this->matching = 0;
+    this->pattern_value = 0;
+    this->pattern_boost = 0.0f;
+    this->segment_transfer = new unsigned int[num_segments * NUM_DELTAS]();
+    for (unsigned int d = 0; d < NUM_DELTAS; d++) {
+        total_transfer[d] = 0;
+    }
+    this->scratch_matches = new unsigned int[num_segments];
+}
+
+HeuristicContext::~HeuristicContext() {
+    delete[] segment_max;
+    delete[] segment_length;
+    delete[] jugs;
+    delete[] segment_matches;
+    delete[] segment_transfer;
+    delete[] scratch_matches;
+}
+
+unsigned int HeuristicContext::segmentOf(unsigned int i) const {
+    return i / SEGMENT_SIZE;
+}
+
+unsigned int HeuristicContext::weightOf(const State &state) {
+    TRACE_SCOPE;
+    float state_weights[3];
+    HeuristicFormula::strategyWeights(state.depth, size, state_weights);
+    float boost = HeuristicFormula::patternBoost(state_weights);
+
+    unsigned int state_matching = 0;
+    unsigned int pattern = 0;
+    std::fill(scratch_matches, scratch_matches + num_segments, 0u);
+    for (unsigned int i = 0; i < size; i++) {
+        if (state.jugs[i] == target[i]) {
+            state_matching++;
+            scratch_matches[segmentOf(i)]++;
+            pattern += HeuristicFormula::patternTerm(boost, i, size);
+        }
+    }
+
+    float global_momentum =
+        HeuristicFormula::globalMomentum(state_matching, size);
+    unsigned int transfer = 0;
+    for (unsigned int s = 0; s < num_segments; s++) {
+        float factor = HeuristicFormula::transferFactor(
+            state_weights, global_momentum, scratch_matches[s],
+            segment_length[s]);
+        unsigned int end = s * SEGMENT_SIZE + segment_length[s];
+        for (unsigned int i = s * SEGMENT_SIZE; i < end; i++) {
+            if (state.jugs[i] != target[i]) {
+                transfer += HeuristicFormula::transferTerm(
+                    state.jugs[i], target[i], segment_max[s], factor);
+            }
+        }
+    }
+    return HeuristicFormula::combine(transfer, pattern, state.depth,
+                                     state_matching, size);
+}
+
+// O(n) por expansion: los pesos de estrategia son los de la profundidad de
+// los hijos, y las transferencias por segmento se dejan listas para cada
+// cantidad posible de jarras correctas del hijo
+void HeuristicContext::load(const State &parent) {
+    TRACE_SCOPE;
+    this->parent = &parent;
+    memcpy(jugs, parent.jugs, size * sizeof(unsigned int));
+    HeuristicFormula::strategyWeights(parent.depth + 1, size, weights);
+    pattern_boost = HeuristicFormula::patternBoost(weights);
+
+    matching = 0;
+    pattern_value = 0;
+    std::fill(segment_matches, segment_matches + num_segments, 0u);
+    for (unsigned int i = 0; i < size; i++) {
+        if (jugs[i] == target[i]) {
+            matching++;
+            segment_matches[segmentOf(i)]++;
+            pattern_value +=
+                HeuristicFormula::patternTerm(pattern_boost, i, size);
+        }
+    }
+
+    for (unsigned int d = 0; d < NUM_DELTAS; d++) {
+        total_transfer[d] = 0;
+        int child_matching = static_cast<int>(matching) +
+                             static_cast<int>(d) - MAX_MATCH_DELTA;
+        if (child_matching < 0 || child_matching > static_cast<int>(size)) {
+            continue;
+        }
+        float global_momentum =
+            HeuristicFormula::globalMomentum(child_matching, size);
+        for (unsigned int s = 0; s < num_segments; s++) {
+            unsigned int transfer = segmentTransfer(
+                s, jugs, segment_matches[s], global_momentum);
+            segment_transfer[s * NUM_DELTAS + d] = transfer;
+            total_transfer[d] += transfer;
+        }
+    }
+}
+
+// se aplica el movimiento sobre la copia, se corrigen el patron y las
+// correctas de las jarras que cambian, y se rehacen solo sus segmentos
+unsigned int HeuristicContext::childWeight(const State::Move &move) {
+    parent->applyMove(move, capacities, jugs);
+    unsigned int changed[2] = {move.from, move.to};
+    unsigned int num_changed = move.type == State::Move::POUR ? 2 : 1;
+    unsigned int saved_matches[2];
+    int delta = 0;
+    unsigned int pattern = pattern_value;
+    for (unsigned int k = 0; k < num_changed; k++) {
+        saved_matches[k] = segment_matches[segmentOf(changed[k])];
+    }
+    for (unsigned int k = 0; k < num_changed; k++) {
+        unsigned int c = changed[k];
+        bool was_matching = parent->jugs[c] == target[c];
+        bool now_matching = jugs[c] == target[c];
+        if (was_matching == now_matching) {
+            continue;
+        }
+        unsigned int term =
+            HeuristicFormula::patternTerm(pattern_boost, c, size);
+        if (now_matching) {
+            delta++;
+            segment_matches[segmentOf(c)]++;
+            pattern += term;
+        } else {
+            delta--;
+            segment_matches[segmentOf(c)]--;
+            pattern -= term;
+        }
+    }
+
+    float global_momentum =
+        HeuristicFormula::globalMomentum(matching + delta, size);
+    unsigned int d = static_cast<unsigned int>(delta + MAX_MATCH_DELTA);
+    unsigned int transfer = total_transfer[d];
+    for (unsigned int k = 0; k < num_changed; k++) {
+        unsigned int s = segmentOf(changed[k]);
+        if (k == 1 && s == segmentOf(changed[0])) {
+            break;
+        }
+        transfer = transfer - segment_transfer[s * NUM_DELTAS + d] +
+                   segmentTransfer(s, jugs, segment_matches[s],
+                                   global_momentum);
+    }
+
+    // se deshace en orden inverso por si ambas jarras son del mismo segmento
+    for (unsigned int k = num_changed; k-- > 0;) {
+        jugs[changed[k]] = parent->jugs[changed[k]];
+        segment_matches[segmentOf(changed[k])] = saved_matches[k];
+    }
+    unsigned int child_matching = matching + delta;
+    return HeuristicFormula::combine(transfer, pattern, parent->depth + 1,
+                                     child_matching, size);
+}
+
+unsigned int HeuristicContext::segmentTransfer(unsigned int segment,
+                                               const unsigned int *values,
+                                               unsigned int matches,
+                                               float global_momentum) const {
+    float factor = HeuristicFormula::transferFactor(
+        weights, global_momentum, matches, segment_length[segment]);
+    unsigned int transfer = 0;
+    unsigned int end = segment * SEGMENT_SIZE + segment_length[segment];
+    for (unsigned int i = segment * SEGMENT_SIZE; i < end; i++) {
+        if (values[i] != target[i]) {
+            transfer += HeuristicFormula::transferTerm(
+                values[i], target[i], segment_max[segment], factor);
+        }
+    }
+    return transfer;
+}
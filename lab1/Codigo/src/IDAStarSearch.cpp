@@ -0,0 +1,208 @@
+#include "../include/IDAStarSearch.h"
+
+IDAStarSearch::IDAStarSearch(State *initial_state, State *target_state,
+                             const unsigned int *capacities,
+                             size_t memory_budget,
+                             const SearchLimits &limits)
+    : encoding(capacities, initial_state->size),
+      zobrist(capacities, initial_state->size),
+      state_pool(initial_state->size, &encoding, &zobrist),
+      governor(limits) {
+    TRACE_SCOPE;
+    this->capacities = capacities;
+    this->target_state = target_state;
+    this->start_state =
+        state_pool.allocate(initial_state->jugs, 0, 0, nullptr);
+    // cada entrada cuesta su registro en el pool mas su slot en la tabla, que
+    // se mantiene bajo el factor de carga maximo
+    size_t slot_bytes = sizeof(HashTable::Bucket) + sizeof(State *);
+    size_t entry_bytes = state_pool.record_size +
+                         static_cast<size_t>(slot_bytes /
+                                             HashTable::MAX_LOAD_FACTOR) +
+                         1;
+    this->max_transpositions = memory_budget / entry_bytes;
+    this->stack_capacity = 64;
+    this->stack = new Frame[stack_capacity];
+    this->stack_size = 0;
+    this->expanded = 0;
+}
+
+IDAStarSearch::~IDAStarSearch() {
+    TRACE_SCOPE;
+    while (stack_size > 0) {
+        popFrame();
+    }
+    delete[] stack;
+    transpositions.clear();
+}
+
+bool IDAStarSearch::isGoal(const State *state) const {
+    return memcmp(state->jugs, target_state->jugs,
+                  state->size * sizeof(unsigned int)) == 0;
+}
+
+// Iteraciones con umbral creciente. Cada una parte del siguiente f que quedo
+// fuera de la anterior; si no queda ninguno no hay solucion
+Search::Path IDAStarSearch::findPath() {
+    TRACE_SCOPE;
+    unsigned int threshold = start_state->movesLowerBound(*target_state);
+    unsigned int iteration = 0;
+    Search::Path path = {nullptr, 0, 0, StopReason::COMPLETED};
+    governor = LimitGovernor(governor.limits);
+    // el inicial con g = 0 nunca se vuelve a visitar
+    transpositions.insert(
+        state_pool.allocate(start_state->jugs, 0, 0, nullptr));
+
+    while (threshold != NO_BOUND) {
+        iteration++;
+        pushFrame(start_state);
+        unsigned int next_threshold = depthFirst(threshold, iteration);
+        if (stack_size > 0) {
+            path = buildPath();
+            break;
+        }
+        // el umbral de la iteracion cortada sigue siendo cota del optimo
+        if (governor.reason != StopReason::COMPLETED) {
+            path = {nullptr, 0, threshold, governor.reason};
+            break;
+        }
+        threshold = next_threshold;
+    }
+
+    std::cout << "\nSearch statistics:" << std::endl;
+    std::cout << "Expanded states: " << expanded << std::endl;
+    std::cout << "Iterations: " << iteration << ", transpositions: "
+              << transpositions.size << "/" << max_transpositions
+              << std::endl;
+    return path;
+}
+
+// DFS con la pila explicita. Si encuentra el objetivo deja el camino en la
+// pila; si no, la deja vacia y devuelve el menor f que supero el umbral
+unsigned int IDAStarSearch::depthFirst(unsigned int threshold,
+                                       unsigned int iteration) {
+    TRACE_SCOPE;
+    unsigned int next_threshold = NO_BOUND;
+
+    while (stack_size > 0) {
+        Frame &top = stack[stack_size - 1];
+        if (isGoal(top.state)) {
+            return threshold;
+        }
+        if (governor.exceeded(expanded, state_pool.live_states,
+                              reservedBytes())) {
+            while (stack_size > 0) {
+                popFrame();
+            }
+            return NO_BOUND;
+        }
+        if (!top.children) {
+            top.children = top.state->generateSuccessors(
+                capacities, top.num_children, &state_pool);
+            sortChildren(top.children, top.num_children);
+            expanded++;
+        }
+        if (top.next_child == top.num_children) {
+            popFrame();
+            continue;
+        }
+
+        State *child = top.children[top.next_child];
+        top.children[top.next_child] = nullptr;
+        top.next_child++;
+
+        unsigned int f = child->depth + child->movesLowerBound(*target_state);
+        if (f > threshold) {
+            next_threshold = std::min(next_threshold, f);
+            state_pool.release(child);
+            continue;
+        }
+        if (pruneByTable(child, iteration)) {
+            state_pool.release(child);
+            continue;
+        }
+        pushFrame(child);
+    }
+    return next_threshold;
+}
+
+// Se poda si ya se llego al estado con menor g, o con el mismo g en esta
+// iteracion. Si hay espacio se guarda una copia, sino solo se actualiza lo
+// que ya esta en la tabla
+bool IDAStarSearch::pruneByTable(State *child, unsigned int iteration) {
+    State *seen = transpositions.lookup(child);
+    if (seen) {
+        if (seen->depth < child->depth ||
+            (seen->depth == child->depth && seen->weight == iteration)) {
+            return true;
+        }
+        seen->depth = child->depth;
+        seen->weight = iteration;
+        return false;
+    }
+    if (transpositions.size < max_transpositions) {
+        transpositions.insert(state_pool.allocate(
+            child->jugs, child->depth, iteration, nullptr, child->hash));
+    }
+    return false;
+}
+
+void IDAStarSearch::pushFrame(State *state) {
+    if (stack_size == stack_capacity) {
+        Frame *bigger = new Frame[stack_capacity * 2];
+        memcpy(bigger, stack, stack_size * sizeof(Frame));
+        delete[] stack;
+        stack = bigger;
+        stack_capacity *= 2;
+    }
+    stack[stack_size].state = state;
+    stack[stack_size].children = nullptr;
+    stack[stack_size].num_children = 0;
+    stack[stack_size].next_child = 0;
+    stack_size++;
+}
+
+// libera los hijos no visitados y el propio estado, salvo el inicial
+void IDAStarSearch::popFrame() {
+    Frame &top = stack[stack_size - 1];
+    if (top.children) {
+        for (unsigned int i = top.next_child; i < top.num_children; i++) {
+            state_pool.release(top.children[i]);
+        }
+        delete[] top.children;
+    }
+    if (top.state != start_state) {
+        state_pool.release(top.state);
+    }
+    stack_size--;
+}
+
+// insercion por peso de la heuristica, los hijos son pocos
+void IDAStarSearch::sortChildren(State **children,
+                                 unsigned int num_children) const {
+    for (unsigned int i = 0; i < num_children; i++) {
+        children[i]->calculateHeuristic(*target_state);
+    }
+    for (unsigned int i = 1; i < num_children; i++) {
+        State *child = children[i];
+        unsigned int j = i;
+        while (j > 0 && children[j - 1]->weight > child->weight) {
+            children[j] = children[j - 1];
+            j--;
+        }
+        children[j] = child;
+    }
+}
+
+Search::Path IDAStarSearch::buildPath() const {
+    State **path_states = new State *[stack_size];
+    for (unsigned int i = 0; i < stack_size; i++) {
+        path_states[i] = stack[i].state;
+    }
+    return {path_states, stack_size, stack_size - 1, StopReason::COMPLETED};
+}
+
+size_t IDAStarSearch::reservedBytes() const {
+    return state_pool.reservedBytes() + transpositions.reservedBytes() +
+           stack_capacity * sizeof(Frame);
+}
@@ -0,0 +1,74 @@
+#include "../include/MixedRadix.h"
+#include <algorithm>
+
+MixedRadix::MixedRadix() {
+    this->size = 0;
+    this->radix = nullptr;
+    this->stride = nullptr;
+    this->total = 0;
+}
+
+MixedRadix::MixedRadix(const unsigned int *capacities, unsigned int size) {
+    this->size = size;
+    this->radix = new unsigned int[size];
+    this->stride = new uint64_t[size];
+    uint64_t current = 1;
+    for (unsigned int i = 0; i < size; i++) {
+        radix[i] = capacities[i] + 1;
+        stride[i] = current;
+        current *= radix[i];
+    }
+    this->total = current;
+}
+
+MixedRadix::MixedRadix(const MixedRadix &other) : MixedRadix() {
+    *this = other;
+}
+
+MixedRadix &MixedRadix::operator=(const MixedRadix &other) {
+    if (this == &other) {
+        return *this;
+    }
+    delete[] radix;
+    delete[] stride;
+    size = other.size;
+    total = other.total;
+    radix = new unsigned int[size];
+    stride = new uint64_t[size];
+    std::copy(other.radix, other.radix + size, radix);
+    std::copy(other.stride, other.stride + size, stride);
+    return *this;
+}
+
+MixedRadix::~MixedRadix() {
+    delete[] radix;
+    delete[] stride;
+}
+
+uint64_t MixedRadix::index(const unsigned int *values) const {
+    uint64_t result = 0;
+    for (unsigned int i = 0; i < size; i++) {
+        result += values[i] * stride[i];
+    }
+    return result;
+}
+
+void MixedRadix::decode(uint64_t index, unsigned int *values) const {
+    for (unsigned int i = 0; i < size; i++) {
+        values[i] = static_cast<unsigned int>(index % radix[i]);
+        index /= radix[i];
+    }
+}
+
+uint64_t MixedRadix::spaceSize(const unsigned int *capacities,
+                               unsigned int size) {
+    uint64_t total = 1;
+    for (unsigned int i = 0; i < size; i++) {
+        uint64_t r = static_cast<uint64_t>(capacities[i]) + 1;
+        if (total > UINT64_MAX / r) {
+            return 0;
+        }
+        total *= r;
+    }
+    return total;
+}
@@ -0,0 +1,23 @@
+#include "../include/OpenList.h"
+
+OpenList::OpenList(OpenListBackend backend, BucketQueue::TieBreak tie_break) {
+    this->backend = backend;
+    this->heap = nullptr;
+    this->buckets = nullptr;
+    if (backend == OpenListBackend::BUCKET_QUEUE) {
+        buckets = new BucketQueue(tie_break);
+    } else {
+        heap = new PairingHeap();
+    }
+}
+
+// los estados son del pool del Search, solo se liberan las estructuras
+OpenList::~OpenList() {
+    delete heap;
+    delete buckets;
+}
+
+const char *OpenList::backendName(OpenListBackend backend) {
+    return backend == OpenListBackend::BUCKET_QUEUE ? "bucket queue"
+                                                    : "pairing heap";
+}
@@ -0,0 +1,317 @@
+#include "../include/PatternDatabase.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PatternDatabase::PatternDatabase(const unsigned int *capacities,
+                                 const unsigned int *target, unsigned int size,
+                                 const std::string &cache_dir) {
+    TRACE_SCOPE;
+    this->size = size;
+    this->capacities = new unsigned int[size];
+    this->target = new unsigned int[size];
+    memcpy(this->capacities, capacities, size * sizeof(unsigned int));
+    memcpy(this->target, target, size * sizeof(unsigned int));
+    this->patterns = nullptr;
+    this->num_patterns = 0;
+    this->table_bytes = 0;
+    this->table = nullptr;
+    this->mapped = nullptr;
+    this->mapped_size = 0;
+    this->loaded_from_cache = false;
+    this->cache_path =
+        cache_dir.empty()
+            ? std::string()
+            : cache_dir + "/" + cacheFileName(capacities, target, size);
+
+    partition();
+    if (!cache_path.empty() && load()) {
+        loaded_from_cache = true;
+        return;
+    }
+    build();
+    if (!cache_path.empty() && !save()) {
+        std::cerr << "No se pudo guardar la PDB en " << cache_path << "\n";
+    }
+}
+
+PatternDatabase::~PatternDatabase() {
+    if (mapped) {
+        munmap(mapped, mapped_size);
+    } else {
+        delete[] table;
+    }
+    for (unsigned int p = 0; p < num_patterns; p++) {
+        delete[] patterns[p].jugs;
+    }
+    delete[] patterns;
+    delete[] capacities;
+    delete[] target;
+}
+
+unsigned int PatternDatabase::lookup(const unsigned int *jugs) const {
+    unsigned int best = 0;
+    for (unsigned int p = 0; p < num_patterns; p++) {
+        const Pattern &pattern = patterns[p];
+        uint64_t index = 0;
+        for (unsigned int k = 0; k < pattern.num_jugs; k++) {
+            index += jugs[pattern.jugs[k]] * pattern.radix.stride[k];
+        }
+        unsigned int distance = table[pattern.offset + index];
+        if (distance == UNREACHABLE) {
+            return UNREACHABLE;
+        }
+        best = distance > best ? distance : best;
+    }
+    return best;
+}
+
+// grupos de jarras consecutivas mientras el espacio abstracto quepa en
+// MAX_PATTERN_ENTRIES. Una jarra que sola no cabe queda fuera de todo patron
+void PatternDatabase::partition() {
+    patterns = new Pattern[size];
+    unsigned int *group = new unsigned int[size];
+    unsigned int group_size = 0;
+    uint64_t group_entries = 1;
+
+    for (unsigned int i = 0; i <= size; i++) {
+        uint64_t radix = i < size ? capacities[i] + 1ull : 0;
+        bool fits = i < size && group_entries * radix <= MAX_PATTERN_ENTRIES;
+        if (!fits && group_size > 0) {
+            Pattern &pattern = patterns[num_patterns++];
+            pattern.num_jugs = group_size;
+            pattern.jugs = new unsigned int[group_size];
+            unsigned int *pattern_caps = new unsigned int[group_size];
+            for (unsigned int k = 0; k < group_size; k++) {
+                pattern.jugs[k] = group[k];
+                pattern_caps[k] = capacities[group[k]];
+            }
+            pattern.radix = MixedRadix(pattern_caps, group_size);
+            pattern.offset = table_bytes;
+            table_bytes += pattern.radix.total;
+            delete[] pattern_caps;
+            group_size = 0;
+            group_entries = 1;
+        }
+        if (i < size && radix <= MAX_PATTERN_ENTRIES) {
+            group[group_size++] = i;
+            group_entries *= radix;
+        }
+    }
+    delete[] group;
+
+    for (unsigned int p = 0; p < num_patterns; p++) {
+        Pattern &pattern = patterns[p];
+        pattern.outside_capacity = 0;
+        for (unsigned int i = 0; i < size; i++) {
+            bool inside = false;
+            for (unsigned int k = 0; k < pattern.num_jugs; k++) {
+                inside = inside || pattern.jugs[k] == i;
+            }
+            if (!inside && capacities[i] > pattern.outside_capacity) {
+                pattern.outside_capacity = capacities[i];
+            }
+        }
+    }
+}
+
+void PatternDatabase::build() {
+    TRACE_SCOPE;
+    table = new unsigned char[table_bytes];
+    uint64_t max_entries = 0;
+    for (unsigned int p = 0; p < num_patterns; p++) {
+        if (patterns[p].radix.total > max_entries) {
+            max_entries = patterns[p].radix.total;
+        }
+    }
+    uint32_t *queue = new uint32_t[max_entries];
+    for (unsigned int p = 0; p < num_patterns; p++) {
+        buildPattern(patterns[p], table + patterns[p].offset, queue);
+    }
+    delete[] queue;
+}
+
+// BFS hacia atras desde la proyeccion del objetivo, generando predecesores
+// abstractos: el valor de una jarra pudo ser cualquiera si quedo llena o
+// vacia, o estar a lo mas outside_capacity de distancia por un trasvase con
+// afuera; los trasvases dentro del patron son los de generatePredecessors
+void PatternDatabase::buildPattern(const Pattern &pattern,
+                                   unsigned char *distances,
+                                   uint32_t *queue) const {
+    TRACE_SCOPE;
+    const MixedRadix &radix = pattern.radix;
+    unsigned int n = pattern.num_jugs;
+    unsigned int *values = new unsigned int[n];
+    unsigned int *caps = new unsigned int[n];
+    for (unsigned int k = 0; k < n; k++) {
+        values[k] = target[pattern.jugs[k]];
+        caps[k] = capacities[pattern.jugs[k]];
+    }
+
+    memset(distances, UNREACHABLE, radix.total);
+    uint64_t goal = radix.index(values);
+    distances[goal] = 0;
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    queue[tail++] = static_cast<uint32_t>(goal);
+
+    while (head < tail) {
+        uint64_t index = queue[head++];
+        radix.decode(index, values);
+        unsigned int next = distances[index] + 1;
+        // se satura antes de UNREACHABLE, una cota menor sigue siendo valida
+        unsigned char level = static_cast<unsigned char>(
+            next < UNREACHABLE ? next : UNREACHABLE - 1);
+
+        for (unsigned int a = 0; a < n; a++) {
+            uint64_t base = index - values[a] * radix.stride[a];
+            bool any = values[a] == 0 || values[a] == caps[a];
+            for (unsigned int v = 0; v <= caps[a]; v++) {
+                unsigned int gap = v > values[a] ? v - values[a]
+                                                 : values[a] - v;
+                if (gap == 0 || (!any && gap > pattern.outside_capacity)) {
+                    continue;
+                }
+                uint64_t neighbor = base + v * radix.stride[a];
+                if (distances[neighbor] == UNREACHABLE) {
+                    distances[neighbor] = level;
+                    queue[tail++] = static_cast<uint32_t>(neighbor);
+                }
+            }
+
+            // Transfer a -> b dentro del patron
+            for (unsigned int b = 0; b < n; b++) {
+                if (a == b || (values[a] != 0 && values[b] != caps[b])) {
+                    continue;
+                }
+                unsigned int max_amount = caps[a] - values[a];
+                if (values[b] < max_amount) {
+                    max_amount = values[b];
+                }
+                for (unsigned int t = 1; t <= max_amount; t++) {
+                    uint64_t neighbor =
+                        index + t * radix.stride[a] - t * radix.stride[b];
+                    if (distances[neighbor] == UNREACHABLE) {
+                        distances[neighbor] = level;
+                        queue[tail++] = static_cast<uint32_t>(neighbor);
+                    }
+                }
+            }
+        }
+    }
+
+    delete[] values;
+    delete[] caps;
+}
+
+size_t PatternDatabase::dataOffset() const {
+    size_t raw = sizeof(FileHeader) +
+                 (2 * size + num_patterns) * sizeof(uint32_t);
+    return (raw + 7) & ~static_cast<size_t>(7);
+}
+
+// mapea el archivo y revisa que sea de estas capacidades, objetivo y
+// particion; si algo no calza se reconstruye
+bool PatternDatabase::load() {
+    TRACE_SCOPE;
+    int fd = open(cache_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    size_t expected = dataOffset() + table_bytes;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != expected) {
+        close(fd);
+        return false;
+    }
+    void *base = mmap(nullptr, expected, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    const FileHeader *header = static_cast<const FileHeader *>(base);
+    const uint32_t *fields = reinterpret_cast<const uint32_t *>(header + 1);
+    bool valid = header->magic == MAGIC && header->version == VERSION &&
+                 header->jug_count == size &&
+                 header->num_patterns == num_patterns &&
+                 header->table_bytes == table_bytes;
+    for (unsigned int i = 0; valid && i < size; i++) {
+        valid = fields[i] == capacities[i] && fields[size + i] == target[i];
+    }
+    for (unsigned int p = 0; valid && p < num_patterns; p++) {
+        valid = fields[2 * size + p] == patterns[p].num_jugs;
+    }
+    if (!valid) {
+        munmap(base, expected);
+        return false;
+    }
+
+    mapped = base;
+    mapped_size = expected;
+    table = static_cast<unsigned char *>(base) + dataOffset();
+    return true;
+}
+
+// se escribe a un temporal y se renombra, asi otra corrida nunca mapea un
+// archivo a medio escribir
+bool PatternDatabase::save() const {
+    TRACE_SCOPE;
+    std::string dir = cache_path.substr(0, cache_path.find_last_of('/'));
+    mkdir(dir.c_str(), 0755);
+
+    std::string tmp_path = cache_path + ".tmp";
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    FileHeader header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.jug_count = size;
+    header.num_patterns = num_patterns;
+    header.table_bytes = table_bytes;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(capacities),
+               size * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char *>(target),
+               size * sizeof(uint32_t));
+    for (unsigned int p = 0; p < num_patterns; p++) {
+        uint32_t jugs = patterns[p].num_jugs;
+        file.write(reinterpret_cast<const char *>(&jugs), sizeof(jugs));
+    }
+    size_t written = sizeof(header) +
+                     (2 * size + num_patterns) * sizeof(uint32_t);
+    const char padding[8] = {0};
+    file.write(padding, dataOffset() - written);
+    file.write(reinterpret_cast<const char *>(table), table_bytes);
+    file.close();
+    if (!file) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return std::rename(tmp_path.c_str(), cache_path.c_str()) == 0;
+}
+
+// FNV-1a de capacidades y objetivo, el contenido se valida igual al cargar
+std::string PatternDatabase::cacheFileName(const unsigned int *capacities,
+                                           const unsigned int *target,
+                                           unsigned int size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned int i = 0; i < 2 * size; i++) {
+        unsigned int value = i < size ? capacities[i] : target[i - size];
+        for (unsigned int b = 0; b < 4; b++) {
+            hash ^= (value >> (8 * b)) & 0xFF;
+            hash *= 0x100000001b3ull;
+        }
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "pdb_%016llx.bin",
+             static_cast<unsigned long long>(hash));
+    return name;
+}
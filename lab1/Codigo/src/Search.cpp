@@ -1,17 +1,92 @@
 #include "../include/Search.h"
+#include "../include/DenseSearch.h"
+#include "../include/ExternalSearch.h"
+#include <cassert>
+
+// std::min toma las constantes por referencia, en C++11 necesitan definicion
+constexpr unsigned int Search::DEPTH_MASK;
+constexpr float Search::StagnationParams::INITIAL_TEMPERATURE;
+
+Search::Options::Options() {
+    mode = SearchMode::HEURISTIC;
+    closed_backend = DEFAULT_CLOSED_SET_BACKEND;
+    open_backend = OpenListBackend::PAIRING_HEAP;
+    tie_break = BucketQueue::TieBreak::LIFO;
+    memory_budget = 256u << 20;
+    use_pdb = false;
+    pdb_cache_dir = PatternDatabase::DEFAULT_CACHE_DIR;
+    external_dir = ExternalSearch::DEFAULT_WORK_DIR;
+    partial_expansion = false;
+    deferred_evaluation = false;
+    suboptimality = 1.5f;
+    dense_max_states = DenseSearch::DEFAULT_MAX_STATES;
+    threads = 0;
+}
 
 Search::Search(State *initial_state, State *target_state,
-               const unsigned int *capacities) {
+               const unsigned int *capacities, const Options &options)
+    : encoding(capacities, initial_state->size),
+      zobrist(capacities, initial_state->size),
+      state_pool(initial_state->size, &encoding, &zobrist),
+      heuristic(*target_state, capacities),
+      open_list(options.open_backend, options.tie_break),
+      open_index(options.table_config),
+      closed_list(options.closed_backend, options.table_config) {
     TRACE_SCOPE;
     this->capacities = capacities;
+    this->options = options;
     this->initial_state = initial_state;
     this->target_state = target_state;
-    this->initial_state->calculateHeuristic(*target_state);
+    this->start_state = state_pool.allocate(
+        initial_state->jugs, initial_state->depth, 0, nullptr);
+    this->open_duplicates = 0;
+    this->partial_requeues = 0;
+    this->deferred_requeues = 0;
+    this->moves = new State::Move[initial_state->size *
+                                  (initial_state->size + 1)];
+    this->scratch_jugs = new unsigned int[initial_state->size];
+    this->probe.size = initial_state->size;
+    this->probe.jugs = scratch_jugs;
+    this->probe.owns_jugs = false;
+    this->probe.hashed = true;
+    this->scratch_key = new uint64_t[encoding.words];
+    this->probe.key = scratch_key;
+    this->probe.key_words = encoding.words;
+    this->best_state = nullptr;
+    // el codigo de movimiento de dos bytes alcanza hasta MAX_CODED_JUGS
+    if (options.closed_backend == ClosedSetBackend::COMPACT &&
+        initial_state->size > State::MAX_CODED_JUGS) {
+        this->options.closed_backend = ClosedSetBackend::ROBIN_HOOD;
+        closed_list.setBackend(ClosedSetBackend::ROBIN_HOOD);
+    }
+    this->pdb = nullptr;
+    this->dense = nullptr;
+    if (options.dense_max_states > 0 &&
+        DenseSearch::fits(capacities, initial_state->size,
+                          options.dense_max_states)) {
+        dense = new DenseSearch(initial_state, target_state, capacities,
+                                options.limits, options.threads);
+    }
+    if (options.mode == SearchMode::OPTIMAL && options.use_pdb && !dense) {
+        pdb = new PatternDatabase(capacities, target_state->jugs,
+                                  target_state->size, options.pdb_cache_dir);
+        std::cout << "PDB: " << pdb->num_patterns << " patrones, "
+                  << pdb->table_bytes << " bytes"
+                  << (pdb->loaded_from_cache ? " (cache)" : "") << "\n";
+    }
+    this->goal_state = state_pool.allocate(target_state->jugs,
+                                           target_state->depth, 0, nullptr);
+    evaluate(this->start_state);
 }
 
 Search::~Search() {
     TRACE_SCOPE;
     cleanUpStates();
+    delete pdb;
+    delete dense;
+    delete[] moves;
+    delete[] scratch_jugs;
+    delete[] scratch_key;
 }
 // Buscador de soluciones del open desde el estado inicial
 // Considerar ademas el agregado del sistema de stagnation para evitar
@@ -20,83 +95,140 @@ Search::~Search() {
 //
 Search::Path Search::findPath() {
     TRACE_SCOPE;
-    open_list.push(initial_state);
+    if (dense) {
+        return dense->findPath();
+    }
+    if (!isDeadEnd(start_state)) {
+        pushOpen(start_state);
+    }
     unsigned int steps = 0;
     unsigned int total_states_generated = 0;
 
     std::random_device rd;
     std::knuth_b rng(rd());
-    StagnationParams stag(initial_state->size);
-    State *best_state = initial_state;
+    StagnationParams stag(start_state->size);
+    best_state = start_state;
+    unsigned int best_distance = distanceToGoal(start_state);
+    LimitGovernor governor(options.limits);
 
     try {
         while (!open_list.empty()) {
-            State *current = open_list.pop();
+            // con un tope pasado se devuelve el camino al mejor estado
+            if (governor.exceeded(steps, state_pool.live_states,
+                                  reservedBytes())) {
+                Path path = reconstructPath(best_state);
+                path.stop_reason = governor.reason;
+                // en modo optimo el menor f que queda en open es cota del
+                // optimo, como en los otros motores optimos
+                if (optimal()) {
+                    path.lower_bound = open_list.peek()->weight >> DEPTH_BITS;
+                }
+                cleanUpStates();
+                std::cout << "\nSearch statistics:" << std::endl;
+                std::cout << "Total states: " << total_states_generated
+                          << ", steps: " << steps << std::endl;
+                return path;
+            }
+            State *current = popOpen();
+            if (!current) {
+                continue;
+            }
             steps++;
             stag.steps_since_last_improvement++;
             stag.steps_since_last_random++;
-            if (current->equals(target_state)) {
-                Path path = reconstructPath(current, total_states_generated);
+            if (current->equals(goal_state)) {
+                Path path = reconstructPath(current);
                 cleanUpStates();
                 std::cout << "\nSearch statistics:" << std::endl;
                 std::cout << "Total states: " << total_states_generated
                           << std::endl;
+                std::cout << "Open duplicates merged: " << open_duplicates
+                          << std::endl;
+                if (deferredEvaluation()) {
+                    std::cout << "Deferred evaluation re-queues: "
+                              << deferred_requeues << std::endl;
+                }
+                if (partialExpansion()) {
+                    std::cout << "Partial expansion re-queues: "
+                              << partial_requeues << std::endl;
+                }
+                if (optimal()) {
+                    std::cout << "Optimal: " << current->depth << " moves"
+                              << std::endl;
+                }
                 return path;
             }
 
             if (!closed_list.contains(current)) {
-                closed_list.insert(current);
+                // evaluacion diferida: se encolo con el peso del padre. Si
+                // con su heuristica ya no es el mejor de open, vuelve a open
+                if (deferredEvaluation() && !current->heuristic_calculated) {
+                    evaluate(current);
+                    if (!open_list.empty() &&
+                        current->weight > open_list.peek()->weight) {
+                        deferred_requeues++;
+                        pushOpen(current);
+                        continue;
+                    }
+                }
 
                 if (current->weight < stag.best_heuristic) {
                     stag.best_heuristic = current->weight;
-                    best_state = current;
                     stag.steps_since_last_improvement = 0;
                 }
+                if (distanceToGoal(current) < best_distance) {
+                    best_distance = distanceToGoal(current);
+                    State *previous_best = best_state;
+                    best_state = current;
+                    retire(previous_best);
+                }
 
-                unsigned int num_successors;
-                State **successors = nullptr;
+                if (partialExpansion()) {
+                    total_states_generated += expandPartially(current);
+                    continue;
+                }
+                closed_list.insert(current);
 
-                try {
-                    successors =
-                        current->generateSuccessors(capacities, num_successors);
-                    total_states_generated += num_successors;
-
-                    for (unsigned int i = 0; i < num_successors; i++) {
-                        if (successors[i] &&
-                            !closed_list.contains(successors[i])) {
-                            successors[i]->calculateHeuristic(*target_state);
-
-                            bool accept =
-                                !stag.annealing_active ||
-                                successors[i]->weight <= current->weight ||
-                                (std::rand() % 100) < (stag.temperature * 100);
-
-                            if (accept) {
-                                open_list.push(successors[i]);
-                                successors[i] = nullptr;
-                            } else {
-                                cleanUpState(successors[i]);
-                                successors[i] = nullptr;
-                            }
-                        } else if (successors[i]) {
-                            cleanUpState(successors[i]);
-                            successors[i] = nullptr;
+                // los hijos se generan como movimientos sobre scratch_jugs y
+                // solo se copian al pool los que pasan closed, la aceptacion
+                // y los duplicados de open
+                unsigned int num_moves =
+                    current->generateMoves(capacities, moves);
+                total_states_generated += num_moves;
+                bool incremental = !optimal() && !deferredEvaluation();
+                if (incremental) {
+                    heuristic.load(*current);
+                }
+                resetProbe(current);
+
+                for (unsigned int k = 0; k < num_moves; k++) {
+                    const State::Move &move = moves[k];
+                    loadProbe(current, move);
+                    if (!closed_list.contains(&probe)) {
+                        if (deferredEvaluation()) {
+                            probe.weight = current->weight;
+                        } else if (incremental) {
+                            probe.weight = heuristic.childWeight(move);
+                            probe.heuristic_calculated = true;
+                        } else {
+                            evaluate(&probe);
                         }
-                    }
-                } catch (...) {
-                    if (successors) {
-                        for (unsigned int i = 0; i < num_successors; i++) {
-                            cleanUpState(successors[i]);
+
+                        bool accept =
+                            !isDeadEnd(&probe) &&
+                            (optimal() || !stag.annealing_active ||
+                             probe.weight <= current->weight ||
+                             (std::rand() % 100) < (stag.temperature * 100));
+
+                        if (accept) {
+                            pushProbe();
                         }
-                        delete[] successors;
                     }
-                    throw;
+                    unloadProbe(current, move);
                 }
 
-                delete[] successors;
-
-                if (stag.steps_since_last_random >=
-                    stag.random_check_interval) {
+                if (!optimal() && stag.steps_since_last_random >=
+                                      stag.random_check_interval) {
                     generateRandomVariations(current, rng,
                                              total_states_generated, stag);
                     stag.steps_since_last_random = 0;
@@ -105,12 +237,16 @@ Search::Path Search::findPath() {
                 stag.updateAdaptiveParams(
                     current->weight < stag.best_heuristic, stag.temperature,
                     static_cast<float>(current->size) / 30.0f);
+                retire(current);
             } else {
                 cleanUpState(current);
             }
         }
 
-        Path path = reconstructPath(best_state, total_states_generated);
+        // en modo optimo agotar open prueba que no hay solucion
+        Path path = optimal()
+                        ? Path{nullptr, 0, 0, StopReason::COMPLETED}
+                        : reconstructPath(best_state);
         cleanUpStates();
         return path;
     } catch (...) {
@@ -119,38 +255,92 @@ Search::Path Search::findPath() {
     }
 }
 // Reconstruir camino en base a los punteros dados por el estado final
-Search::Path Search::reconstructPath(State *final_state,
-                                     unsigned int total_states) {
+Search::Path Search::reconstructPath(State *final_state) {
     TRACE_SCOPE;
     if (!final_state) {
-        return {nullptr, 0};
+        return {nullptr, 0, 0, StopReason::COMPLETED};
     }
 
     unsigned int length = 0;
-    State *current = final_state;
+    State **path_states = nullptr;
+    if (compactClosed()) {
+        path_states = replayPath(final_state, length);
+    } else {
+        State *current = final_state;
+
+        // Count path length
+        while (current != nullptr) {
+            length++;
+            current = current->parent;
+        }
 
-    // Count path length
-    while (current != nullptr) {
-        length++;
-        current = current->parent;
+        // Create path array
+        path_states = new State *[length];
+
+        // Fill path array, los estados siguen en el pool hasta destruir el
+        // Search
+        current = final_state;
+        int index = length - 1;
+        while (current != nullptr) {
+            path_states[index] = current;
+            current = current->parent;
+            index--;
+        }
     }
 
-    // Create path array
-    State **path_states = new State *[length];
+    // la cota solo vale si el camino llega al objetivo
+    bool proven = optimal() && final_state->equals(goal_state);
+    return {path_states, length, proven ? length - 1 : 0,
+            StopReason::COMPLETED};
+}
+
+// se sube por los registros juntando los codigos (el de final_state lo
+// guarda el mismo, la raiz es start_state) y se aplican en orden. Los estados
+// nuevos son del pool, como los del camino por punteros
+State **Search::replayPath(const State *final_state, unsigned int &length) {
+    TRACE_SCOPE;
+    const CompactClosedSet *nodes = closed_list.compact;
+    unsigned int num_moves = 0;
+    if (final_state->parent_node != State::NO_NODE) {
+        num_moves = 1;
+        for (uint32_t node = final_state->parent_node;
+             nodes->parents[node] != State::NO_NODE;
+             node = nodes->parents[node]) {
+            num_moves++;
+        }
+    }
 
-    // Fill path array
-    current = final_state;
-    int index = length - 1;
-    while (current != nullptr) {
-        path_states[index] = current;
-        if (current->parent != nullptr) {
-            closed_list.removeState(current);
+    uint16_t *codes = new uint16_t[num_moves + 1];
+    if (num_moves > 0) {
+        unsigned int index = num_moves - 1;
+        codes[index] = final_state->move_code;
+        for (uint32_t node = final_state->parent_node;
+             nodes->parents[node] != State::NO_NODE;
+             node = nodes->parents[node]) {
+            codes[--index] = nodes->moves[node];
         }
-        current = current->parent;
-        index--;
     }
 
-    return {path_states, length};
+    length = num_moves + 1;
+    State **path_states = new State *[length];
+    path_states[0] = start_state;
+    for (unsigned int i = 0; i < num_moves; i++) {
+        State *previous = path_states[i];
+        memcpy(scratch_jugs, previous->jugs,
+               previous->size * sizeof(unsigned int));
+        previous->applyMove(State::Move::fromCode(codes[i], previous->size),
+                            capacities, scratch_jugs);
+        path_states[i + 1] = state_pool.allocate(
+            scratch_jugs, previous->depth + 1, 0, previous);
+    }
+    delete[] codes;
+    assert(path_states[num_moves]->equals(final_state));
+    return path_states;
+}
+
+size_t Search::reservedBytes() const {
+    return state_pool.reservedBytes() + open_list.reservedBytes() +
+           open_index.reservedBytes() + closed_list.reservedBytes();
 }
 
 void Search::freePath(Path &path) {
@@ -187,6 +377,7 @@ void Search::generateRandomVariations(State *current, std::knuth_b &rng,
 
             unsigned int attempts = 0;
             bool valid_sequence = false;
+            State::Move move;
 
             while (!valid_sequence && attempts < 3) {
                 // ver que hacer siguiente
@@ -207,6 +398,7 @@ void Search::generateRandomVariations(State *current, std::knuth_b &rng,
                             if (transfer > 0) {
                                 new_jugs[from] -= transfer;
                                 new_jugs[to] += transfer;
+                                move = {State::Move::POUR, from, to};
                                 valid_sequence = true;
                             }
                         }
@@ -216,6 +408,7 @@ void Search::generateRandomVariations(State *current, std::knuth_b &rng,
                         unsigned int jug = rng() % current->size;
                         if (new_jugs[jug] < capacities[jug]) {
                             new_jugs[jug] = capacities[jug];
+                            move = {State::Move::FILL, jug, jug};
                             valid_sequence = true;
                         }
                         break;
@@ -224,6 +417,7 @@ void Search::generateRandomVariations(State *current, std::knuth_b &rng,
                         unsigned int jug = rng() % current->size;
                         if (new_jugs[jug] > 0) {
                             new_jugs[jug] = 0;
+                            move = {State::Move::EMPTY, jug, jug};
                             valid_sequence = true;
                         }
                         break;
@@ -235,9 +429,10 @@ void Search::generateRandomVariations(State *current, std::knuth_b &rng,
             if (valid_sequence) {
                 State *new_state = nullptr;
                 try {
-                    new_state = new State(current->size, new_jugs,
-                                          current->depth + 1, 0, current);
-                    new_state->calculateHeuristic(*target_state);
+                    new_state = state_pool.allocate(
+                        new_jugs, current->depth + 1, 0, current);
+                    linkChild(new_state, current, move);
+                    evaluate(new_state);
 
                     bool accept = false;
                     if (new_state->weight < stag.best_heuristic) {
@@ -263,14 +458,14 @@ void Search::generateRandomVariations(State *current, std::knuth_b &rng,
                     }
 
                     if (accept && !closed_list.contains(new_state)) {
-                        open_list.push(new_state);
+                        pushOpen(new_state);
                         total_states_generated++;
                     } else {
-                        delete new_state;
+                        state_pool.release(new_state);
                         new_state = nullptr;
                     }
                 } catch (...) {
-                    delete new_state; // cleanup
+                    state_pool.release(new_state); // cleanup
                     throw;
                 }
             }
@@ -332,45 +527,268 @@ void Search::StagnationParams::updateWeights() {
                 State::adaptive_params.optimization_weight);
 }
 
+bool Search::optimal() const { return options.mode == SearchMode::OPTIMAL; }
+
+// en modo optimo weight es f, la distancia es la cota; si no, la heuristica
+unsigned int Search::distanceToGoal(const State *state) const {
+    return optimal() ? state->lower_bound : state->weight;
+}
+
+// Peso con el que se ordena open. En modo optimo la cota es consistente (un
+// movimiento la cambia en a lo mas 1), asi que el primer pop del objetivo es
+// el camino mas corto
+void Search::evaluate(State *state) {
+    if (!optimal()) {
+        state->weight = heuristic.weightOf(*state);
+        state->heuristic_calculated = true;
+        return;
+    }
+    state->lower_bound = state->movesLowerBound(*target_state);
+    if (pdb) {
+        unsigned int pattern_bound = pdb->lookup(state->jugs);
+        state->dead_end = pattern_bound == PatternDatabase::UNREACHABLE;
+        if (pattern_bound > state->lower_bound) {
+            state->lower_bound = pattern_bound;
+        }
+    }
+    unsigned int f = state->depth + state->lower_bound;
+    unsigned int g = std::min(state->depth, DEPTH_MASK);
+    state->weight = (f << DEPTH_BITS) | (DEPTH_MASK - g);
+}
+
+bool Search::compactClosed() const {
+    return closed_list.backend == ClosedSetBackend::COMPACT;
+}
+
+void Search::linkChild(State *child, const State *parent,
+                       const State::Move &move) const {
+    if (compactClosed()) {
+        child->parent = nullptr;
+        child->parent_node = parent->node;
+        child->move_code = move.code(parent->size);
+    } else {
+        child->parent = const_cast<State *>(parent);
+    }
+}
+
+// solo si se cerro esta misma copia: con EPEA un estado vuelve a open, y si
+// otra copia lo reemplazo puede quedar obsoleto en la bucket queue
+void Search::retire(State *state) {
+    if (compactClosed() && state && state != best_state &&
+        !isSpecialState(state) && closed_list.compact->closedAs(state)) {
+        state_pool.release(state);
+    }
+}
+
+bool Search::partialExpansion() const {
+    return optimal() && options.partial_expansion;
+}
+
+// con la evaluacion diferida los hijos heredan el peso del padre y
+// calculateHeuristic corre solo para los que salen de open
+bool Search::deferredEvaluation() const {
+    return !optimal() && options.deferred_evaluation;
+}
+
+// EPEA*: el F guardado en los bits altos de weight parte en f(n) y solo se
+// crean los hijos con f igual a F. El f de cada hijo sale de mismatchDelta (y
+// de la PDB sobre scratch_jugs) sin construirlo. Si quedan hijos con f mayor,
+// el estado vuelve a open con el menor de esos f; si no, se cierra. Con la
+// cota consistente ningun hijo tiene f menor que el del padre, asi que los de
+// f menor que F ya se generaron antes. Devuelve los hijos creados
+unsigned int Search::expandPartially(State *current) {
+    TRACE_SCOPE;
+    current->expanded = true;
+    unsigned int stored_f = current->weight >> DEPTH_BITS;
+    unsigned int next_f = ~0u;
+    unsigned int mismatched = current->mismatchedJugs(*target_state);
+    unsigned int num_moves = current->generateMoves(capacities, moves);
+    unsigned int generated = 0;
+    // los hijos apuntan al registro del padre, que aun no se cierra
+    if (compactClosed() && current->node == State::NO_NODE) {
+        closed_list.compact->record(current);
+    }
+    resetProbe(current);
+
+    for (unsigned int k = 0; k < num_moves; k++) {
+        const State::Move &move = moves[k];
+        loadProbe(current, move);
+        unsigned int bound =
+            (mismatched +
+             current->mismatchDelta(move, capacities, *target_state) + 1) /
+            2;
+        bool dead_end = false;
+        if (pdb) {
+            unsigned int pattern_bound = pdb->lookup(scratch_jugs);
+            dead_end = pattern_bound == PatternDatabase::UNREACHABLE;
+            bound = std::max(bound, pattern_bound);
+        }
+        unsigned int child_f = current->depth + 1 + bound;
+
+        // la PDB prueba que el hijo no llega: ni se genera ni se pospone
+        if (dead_end) {
+            unloadProbe(current, move);
+            continue;
+        }
+        if (child_f == stored_f) {
+            generated++;
+            if (!closed_list.contains(&probe)) {
+                evaluate(&probe);
+                assert(probe.weight >> DEPTH_BITS == stored_f);
+                pushProbe();
+            }
+        } else if (child_f > stored_f) {
+            next_f = std::min(next_f, child_f);
+        }
+        unloadProbe(current, move);
+    }
+
+    if (next_f == ~0u) {
+        closed_list.insert(current);
+        retire(current);
+    } else {
+        unsigned int g = std::min(current->depth, DEPTH_MASK);
+        current->weight = (next_f << DEPTH_BITS) | (DEPTH_MASK - g);
+        pushOpen(current);
+        partial_requeues++;
+    }
+    return generated;
+}
+
+// la PDB prueba que desde aqui no se llega al objetivo
+bool Search::isDeadEnd(const State *state) const {
+    return pdb && state->dead_end;
+}
+
+// Encola state si su configuracion no esta en open. Si ya esta, se queda la
+// copia menos profunda (o de menor peso con igual profundidad) y la otra se
+// descarta. Con pairing heap la copia encolada se cambia en su nodo; con la
+// bucket queue se encola la nueva y la vieja queda obsoleta en la cola
+void Search::pushOpen(State *state) {
+    TRACE_SCOPE;
+    State *queued = open_index.lookup(state);
+    if (queued) {
+        open_duplicates++;
+        if (!isBetterCopy(state, queued)) {
+            cleanUpState(state);
+            return;
+        }
+    }
+    enqueue(state, queued);
+}
+
+void Search::enqueue(State *state, State *queued) {
+    if (!queued) {
+        state->open_handle = open_list.push(state);
+        open_index.insert(state);
+        return;
+    }
+
+    open_index.replace(state);
+    if (queued->open_handle) {
+        open_list.replace(queued->open_handle, state);
+        state->open_handle = queued->open_handle;
+        queued->open_handle = nullptr;
+        cleanUpState(queued);
+    } else {
+        state->open_handle = open_list.push(state);
+    }
+}
+
+void Search::resetProbe(const State *parent) {
+    memcpy(scratch_jugs, parent->jugs, parent->size * sizeof(unsigned int));
+    encoding.pack(scratch_jugs, scratch_key);
+}
+
+void Search::loadProbe(const State *parent, const State::Move &move) {
+    parent->applyMove(move, capacities, scratch_jugs);
+    encoding.set(scratch_key, move.from, scratch_jugs[move.from]);
+    encoding.set(scratch_key, move.to, scratch_jugs[move.to]);
+    linkChild(&probe, parent, move);
+    probe.depth = parent->depth + 1;
+    probe.weight = 0;
+    probe.lower_bound = 0;
+    probe.dead_end = false;
+    probe.heuristic_calculated = false;
+    probe.hash = parent->hashed
+                     ? zobrist.childHash(parent->hash, parent->jugs,
+                                         scratch_jugs, move.from, move.to)
+                     : zobrist.hashOf(scratch_jugs);
+}
+
+void Search::unloadProbe(const State *parent, const State::Move &move) {
+    scratch_jugs[move.from] = parent->jugs[move.from];
+    scratch_jugs[move.to] = parent->jugs[move.to];
+    encoding.set(scratch_key, move.from, scratch_jugs[move.from]);
+    encoding.set(scratch_key, move.to, scratch_jugs[move.to]);
+}
+
+// como pushOpen, pero el hijo se copia al pool solo si no hay en open una
+// copia igual o mejor
+void Search::pushProbe() {
+    State *queued = open_index.lookup(&probe);
+    if (queued) {
+        open_duplicates++;
+        if (!isBetterCopy(&probe, queued)) {
+            return;
+        }
+    }
+    State *child = state_pool.allocate(scratch_jugs, probe.depth,
+                                       probe.weight, probe.parent, probe.hash);
+    child->lower_bound = probe.lower_bound;
+    child->heuristic_calculated = probe.heuristic_calculated;
+    child->parent_node = probe.parent_node;
+    child->move_code = probe.move_code;
+    enqueue(child, queued);
+}
+
+// saca el siguiente estado de open. Las copias obsoletas que dejo la bucket
+// queue no estan en el indice, se liberan y se devuelve nullptr
+State *Search::popOpen() {
+    State *state = open_list.pop();
+    state->open_handle = nullptr;
+    if (open_index.lookup(state) != state) {
+        cleanUpState(state);
+        return nullptr;
+    }
+    open_index.removeState(state);
+    return state;
+}
+
+bool Search::isBetterCopy(const State *candidate, const State *queued) {
+    if (candidate->depth != queued->depth) {
+        return candidate->depth < queued->depth;
+    }
+    return candidate->weight < queued->weight;
+}
+
 void Search::cleanupSuccessors(State **successors,
                                unsigned int num_successors) {
     if (successors) {
         for (unsigned int i = 0; i < num_successors; i++) {
-            if (successors[i]) {
-                delete successors[i];
-            }
+            cleanUpState(successors[i]);
         }
         delete[] successors;
     }
 }
 
+// los estados son del pool, se vacian las listas sin recorrer estado por
+// estado y la memoria se devuelve entera cuando se destruye el Search
 void Search::cleanUpStates() {
     TRACE_SCOPE;
-    // Clean up open list
-    while (!open_list.empty()) {
-        State *state = open_list.pop();
-        delete state;
-    }
-
-    // Clean up closed list
-    HashTable::Bucket *buckets = closed_list.buckets;
-    for (unsigned int i = 0; i < closed_list.capacity; i++) {
-        if (buckets[i].occupied && buckets[i].state) {
-            cleanUpState(buckets[i].state);
-            buckets[i].state = nullptr;
-            buckets[i].occupied = false;
-            buckets[i].psl = 0;
-        }
-    }
-    closed_list.size = 0;
+    open_list.clear();
+    open_index.clear();
+    closed_list.clear();
 }
 
+// un estado expandido puede ser parent de otros que siguen vivos
 void Search::cleanUpState(State *state) {
-    if (state && !isSpecialState(state)) {
-        delete state;
+    if (state && !state->expanded && !isSpecialState(state)) {
+        state_pool.release(state);
     }
 }
 
 bool Search::isSpecialState(State *state) const {
-    return state == initial_state || state == target_state;
+    return state == initial_state || state == target_state ||
+           state == start_state || state == goal_state;
 }
@@ -0,0 +1,67 @@
+#include "../include/SearchLimits.h"
+
+SearchLimits::SearchLimits() {
+    this->max_time_ms = 0;
+    this->max_expansions = 0;
+    this->max_live_states = 0;
+    this->max_bytes = 0;
+    this->cancel = nullptr;
+}
+
+// la primera llamada ya mira el reloj y la bandera
+LimitGovernor::LimitGovernor(const SearchLimits &limits) {
+    this->limits = limits;
+    this->start_time = std::chrono::steady_clock::now();
+    this->since_check = CLOCK_CHECK_INTERVAL - 1;
+    this->reason = StopReason::COMPLETED;
+}
+
+bool LimitGovernor::exceeded(size_t expansions, size_t live_states,
+                             size_t bytes) {
+    if (reason != StopReason::COMPLETED) {
+        return true;
+    }
+    if (limits.max_expansions > 0 && expansions >= limits.max_expansions) {
+        reason = StopReason::EXPANSIONS;
+    } else if (limits.max_live_states > 0 &&
+               live_states > limits.max_live_states) {
+        reason = StopReason::LIVE_STATES;
+    } else if (limits.max_bytes > 0 && bytes > limits.max_bytes) {
+        reason = StopReason::MEMORY;
+    } else if (++since_check >= CLOCK_CHECK_INTERVAL) {
+        since_check = 0;
+        if (limits.cancel &&
+            limits.cancel->load(std::memory_order_relaxed)) {
+            reason = StopReason::CANCELLED;
+        } else if (limits.max_time_ms > 0 &&
+                   elapsedMs() >=
+                       static_cast<long long>(limits.max_time_ms)) {
+            reason = StopReason::TIME;
+        }
+    }
+    return reason != StopReason::COMPLETED;
+}
+
+long long LimitGovernor::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start_time)
+        .count();
+}
+
+const char *LimitGovernor::reasonName(StopReason reason) {
+    switch (reason) {
+        case StopReason::COMPLETED:
+            return "completed";
+        case StopReason::TIME:
+            return "time limit";
+        case StopReason::EXPANSIONS:
+            return "expansion limit";
+        case StopReason::LIVE_STATES:
+            return "live state limit";
+        case StopReason::MEMORY:
+            return "memory limit";
+        case StopReason::CANCELLED:
+            return "cancelled";
+    }
+    return "unknown";
+}
@@ -1,4 +1,18 @@
 #include "../include/Solver.h"
+#include <csignal>
+
+// Ctrl-C durante solve() corta la busqueda en vez de matar el programa
+static std::atomic<bool> interrupt_requested(false);
+
+static void requestInterrupt(int) { interrupt_requested.store(true); }
+
+static long long
+elapsedMicros(std::chrono::high_resolution_clock::time_point start_time) {
+    auto end_time = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end_time -
+                                                                 start_time)
+        .count();
+}
 
 Solver::Solver() {
     initialized = false;
@@ -55,19 +69,86 @@ void Solver::solve() {
         start_state->jugs[i] = 0;
     }
 
-    // buscar y solve
-    Search search(start_state, target_state, max_state->jugs);
-
-    auto start_time = std::chrono::high_resolution_clock::now();
-    Search::Path solution = search.findPath();
-    auto end_time = std::chrono::high_resolution_clock::now();
+    // la bandera de cancelacion, si no trae una, es la de Ctrl-C
+    Search::Options options = search_options;
+    if (!options.limits.cancel) {
+        options.limits.cancel = &interrupt_requested;
+    }
+    interrupt_requested.store(false);
+    void (*previous_handler)(int) = std::signal(SIGINT, requestInterrupt);
+
+    // buscar y solve, el camino es valido mientras viva el motor
+    Search::Path solution;
+    if (options.mode == SearchMode::BIDIRECTIONAL) {
+        BidirectionalSearch search(start_state, target_state, max_state->jugs,
+                                   BidirectionalSearch::DEFAULT_MAX_STATES,
+                                   options.limits);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        solution = search.findPath();
+        printSolution(solution, elapsedMicros(start_time));
+    } else if (options.mode == SearchMode::ANYTIME) {
+        AnytimeSearch search(start_state, target_state, max_state->jugs,
+                             options);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        search.setImprovementCallback(
+            [start_time](const Search::Path &path, float weight) {
+                std::cout << "Mejora: " << path.length - 1 << " steps (w = "
+                          << weight << ") a los "
+                          << elapsedMicros(start_time) / 1000.0 << " ms\n";
+            });
+        solution = search.findPath();
+        printSolution(solution, elapsedMicros(start_time));
+    } else if (options.mode == SearchMode::FOCAL) {
+        FocalSearch search(start_state, target_state, max_state->jugs,
+                           options);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        solution = search.findPath();
+        printSolution(solution, elapsedMicros(start_time));
+    } else if (options.mode == SearchMode::IDA_STAR) {
+        IDAStarSearch search(start_state, target_state, max_state->jugs,
+                             options.memory_budget, options.limits);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        solution = search.findPath();
+        printSolution(solution, elapsedMicros(start_time));
+    } else if (options.mode == SearchMode::EXTERNAL) {
+        ExternalSearch search(start_state, target_state, max_state->jugs,
+                              options.memory_budget, options.external_dir,
+                              options.limits);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        solution = search.findPath();
+        printSolution(solution, elapsedMicros(start_time));
+    } else if (options.mode == SearchMode::HDA_STAR) {
+        HDAStarSearch search(start_state, target_state, max_state->jugs,
+                             options.threads, options.limits);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        solution = search.findPath();
+        printSolution(solution, elapsedMicros(start_time));
+    } else {
+        Search search(start_state, target_state, max_state->jugs, options);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        solution = search.findPath();
+        printSolution(solution, elapsedMicros(start_time));
+    }
 
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
-                        end_time - start_time)
-                        .count();
+    std::signal(SIGINT, previous_handler);
+    Search::freePath(solution);
+    delete start_state;
+}
 
+void Solver::printSolution(const Search::Path &solution,
+                           long long duration) const {
+    if (solution.stop_reason != StopReason::COMPLETED) {
+        std::cout << "\nSearch stopped: "
+                  << LimitGovernor::reasonName(solution.stop_reason)
+                  << (solution.length > 0 ? ", best path so far below" : "")
+                  << "\n";
+    }
     if (solution.length == 0) {
         std::cout << "No se encontro solucion\n";
+        if (solution.lower_bound > 0) {
+            std::cout << "Proven lower bound: " << solution.lower_bound
+                      << " steps\n";
+        }
     } else {
         std::cout << "\nSecuencia de estados:\n";
         for (unsigned int i = 0; i < solution.length; i++) {
@@ -79,12 +160,20 @@ void Solver::solve() {
             std::cout << "\n";
         }
         TRACE_PLOT("Solver/Performance/TimeMs", duration / 1000.0);
-        std::cout << "Solution found in " << solution.length - 1 << " steps\n";
+        if (solution.states[solution.length - 1]->equals(target_state)) {
+            std::cout << "Solution found in " << solution.length - 1
+                      << " steps\n";
+        } else {
+            std::cout << "Partial path of " << solution.length - 1
+                      << " steps, target not reached\n";
+        }
+        if (solution.lower_bound > 0) {
+            std::cout << "Proven lower bound: " << solution.lower_bound
+                      << " steps\n";
+        }
         std::cout << "Execution time: " << duration / 1000.0
                   << " milliseconds\n";
     }
-
-    Search::freePath(solution);
 }
 
 void Solver::printCurrentStates() const {
@@ -98,3 +187,11 @@ void Solver::printCurrentStates() const {
 }
 
 bool Solver::isInitialized() const { return initialized; }
+
+void Solver::setSearchOptions(const Search::Options &options) {
+    search_options = options;
+}
+
+const Search::Options &Solver::getSearchOptions() const {
+    return search_options;
+}
@@ -1,13 +1,27 @@
 #include "../include/State.h"
+#include "../include/HeuristicFormula.h"
+#include "../include/StatePool.h"
 using namespace std;
 State::AdaptiveParams State::adaptive_params;
 State::State() {
     this->size = 0;
     this->jugs = nullptr;
+    this->owns_jugs = true;
+    this->expanded = false;
+    this->key = nullptr;
+    this->key_words = 0;
+    this->hash = 0;
+    this->hashed = false;
     this->depth = 0;
     this->weight = 0;
+    this->lower_bound = 0;
+    this->dead_end = false;
     this->parent = nullptr;
     this->heuristic_calculated = false;
+    this->open_handle = nullptr;
+    this->node = NO_NODE;
+    this->parent_node = NO_NODE;
+    this->move_code = 0;
 }
 
 State::AdaptiveParams::AdaptiveParams() {
@@ -24,16 +38,41 @@ State::State(unsigned int size, unsigned int *jugs, unsigned int depth,
     this->size = size;
     this->depth = depth;
     this->weight = weight;
+    this->lower_bound = 0;
+    this->dead_end = false;
     this->parent = parent;
     this->heuristic_calculated = false;
+    this->owns_jugs = true;
+    this->expanded = false;
+    this->key = nullptr;
+    this->key_words = 0;
+    this->hash = 0;
+    this->hashed = false;
+    this->open_handle = nullptr;
+    this->node = NO_NODE;
+    this->parent_node = NO_NODE;
+    this->move_code = 0;
     this->jugs = new unsigned int[size];
     memcpy(this->jugs, jugs, size * sizeof(unsigned int));
 }
 
-State::~State() { delete[] jugs; }
+State::~State() {
+    if (owns_jugs) {
+        delete[] jugs;
+    }
+}
 
+// con llaves empaquetadas basta comparar un par de palabras
 bool State::equals(const State *other) const {
     TRACE_SCOPE;
+    if (key && other->key && key_words == other->key_words) {
+        for (unsigned int w = 0; w < key_words; w++) {
+            if (key[w] != other->key[w]) {
+                return false;
+            }
+        }
+        return true;
+    }
     return memcmp(jugs, other->jugs, size * sizeof(unsigned int)) == 0;
 }
 // Calculo de heuristicas ponderado por profunidad momentum, tamano y peso
@@ -48,14 +87,20 @@ void State::calculateHeuristic(const State &target_state) {
     if (!heuristic_calculated) {
         unsigned int pattern_value = 0;
         unsigned int transfer_value = 0;
-        unsigned int max_jug_size = 0;
         unsigned int matching_jugs = 0;
 
-        // segmentacion
-        const unsigned int SEGMENT_SIZE = 8;
+        // segmentacion, hasta MAX_STACK_SEGMENTS los contadores van en el
+        // stack
+        const unsigned int SEGMENT_SIZE = HeuristicFormula::SEGMENT_SIZE;
+        const unsigned int MAX_STACK_SEGMENTS = 32;
         unsigned int num_segments = (size + SEGMENT_SIZE - 1) / SEGMENT_SIZE;
-        unsigned int *segment_matches = new unsigned int[num_segments]();
-        unsigned int *segment_max = new unsigned int[num_segments]();
+        unsigned int stack_counters[2 * MAX_STACK_SEGMENTS];
+        unsigned int *segment_matches =
+            num_segments <= MAX_STACK_SEGMENTS
+                ? stack_counters
+                : new unsigned int[2 * num_segments];
+        unsigned int *segment_max = segment_matches + num_segments;
+        std::fill(segment_matches, segment_matches + 2 * num_segments, 0u);
 
         // analisis por segment
         for (unsigned int i = 0; i < size; i++) {
@@ -63,9 +108,6 @@ void State::calculateHeuristic(const State &target_state) {
             if (target_state.jugs[i] > segment_max[segment]) {
                 segment_max[segment] = target_state.jugs[i];
             }
-            if (target_state.jugs[i] > max_jug_size) {
-                max_jug_size = target_state.jugs[i];
-            }
             if (jugs[i] == target_state.jugs[i]) {
                 matching_jugs++;
                 segment_matches[segment]++;
@@ -75,55 +117,10 @@ void State::calculateHeuristic(const State &target_state) {
         // Momentum global
         // en base a los estados
         float global_momentum =
-            1.0f - (static_cast<float>(matching_jugs) / size);
+            HeuristicFormula::globalMomentum(matching_jugs, size);
 
-        // calculo de pesos, transiciones lineales, mediano es constante,
-        // siempre queremos balancear
-        float depth_ratio = std::min(1.0f, static_cast<float>(depth) / 60.0f);
         float strategy_weights[3];
-
-        // Exploracion:
-        strategy_weights[0] = std::max(0.25f, 0.6f * (1.0f - depth_ratio));
-
-        // Balance: constante, siempre queremos algo de balance
-        strategy_weights[1] = 0.3f;
-
-        // Optimizacion: crece linealmente
-        strategy_weights[2] = std::min(0.6f, 0.2f + (depth_ratio * 0.4f));
-
-        // Normalizar pesos
-        float sum =
-            strategy_weights[0] + strategy_weights[1] + strategy_weights[2];
-        for (int i = 0; i < 3; i++) {
-            strategy_weights[i] /= sum;
-        }
-
-        // Ponderaror en base a size del problema
-        float size_factor = std::min(1.0f, static_cast<float>(size) / 30.0f);
-
-        if (adaptive_params.consecutive_improvements > 3) {
-            // Aumentar optimizaciom
-            float adjustment = 0.1f * size_factor;
-            strategy_weights[2] += adjustment;
-            strategy_weights[1] -= adjustment * 0.5f;
-            strategy_weights[0] -= adjustment * 0.5f;
-        } else if (adaptive_params.plateaus > 2) {
-            // Aumentar exploracion
-            float adjustment = 0.1f * size_factor;
-            strategy_weights[0] += adjustment;
-            strategy_weights[1] -= adjustment * 0.5f;
-            strategy_weights[2] -= adjustment * 0.5f;
-        }
-
-        // Asegurar almenos un peso
-        strategy_weights[0] = std::max(0.2f, strategy_weights[0]);
-        strategy_weights[1] = std::max(0.2f, strategy_weights[1]);
-        strategy_weights[2] = std::max(0.2f, strategy_weights[2]);
-        // ponderacion
-        sum = strategy_weights[0] + strategy_weights[1] + strategy_weights[2];
-        for (int i = 0; i < 3; i++) {
-            strategy_weights[i] /= sum;
-        }
+        HeuristicFormula::strategyWeights(depth, size, strategy_weights);
 
         TRACE_PLOT("State/Weights/Exploration",
                    static_cast<int64_t>(strategy_weights[0] * 100));
@@ -132,70 +129,31 @@ void State::calculateHeuristic(const State &target_state) {
         TRACE_PLOT("State/Weights/Optimization",
                    static_cast<int64_t>(strategy_weights[2] * 100));
 
-        // Calculo momentum por segmento
+        // bonificacion por estar en la posicion correcta, y si no, las
+        // operaciones que faltan con el momentum del segmento
+        float pattern_boost = HeuristicFormula::patternBoost(strategy_weights);
         for (unsigned int i = 0; i < size; i++) {
             unsigned int segment = i / SEGMENT_SIZE;
-            float segment_momentum =
-                1.0f - (static_cast<float>(segment_matches[segment]) /
-                        std::min(SEGMENT_SIZE, size - segment * SEGMENT_SIZE));
-
-            float combined_momentum =
-                (global_momentum * 0.7f + segment_momentum * 0.3f);
-
             if (jugs[i] == target_state.jugs[i]) {
-                // mayor prioridad a las que estan a la izquierda
-                //  los ejemplos todos funcionan en ese orden, si se cambia esto
-                //  no sirve
-                float position_factor = 1.0f - (static_cast<float>(i) / size);
-
-                float pattern_boost =
-                    strategy_weights[0] * 30.0f + // Exploracion
-                    strategy_weights[1] * 25.0f + // Balance
-                    strategy_weights[2] * 20.0f;  // Optimizacion
-                // bonificacion por estar en la posicion correcta
-                pattern_value += static_cast<unsigned int>(
-                    pattern_boost * (1.0f + position_factor * 0.5f));
+                pattern_value +=
+                    HeuristicFormula::patternTerm(pattern_boost, i, size);
             } else {
-                // diferencia por cada posicion
-                int diff = static_cast<int>(target_state.jugs[i]) -
-                           static_cast<int>(jugs[i]);
-                // max de cada segmeneto
-                unsigned int local_max = segment_max[segment];
-                unsigned int operations = static_cast<unsigned int>(
-                    std::ceil(static_cast<float>(std::abs(diff)) / local_max));
-                // factor de la heuristica, para cada una de las 3 estrategias
-                // considerando el momentum, se prefiere la expacion para los
-                // transfers
-                float transfer_factor =
-                    strategy_weights[0] *
-                        (10.0f - (5.0f * combined_momentum)) + // Exploracion
-                    strategy_weights[1] *
-                        (20.0f - (10.0f * combined_momentum)) + // Balance
-                    strategy_weights[2] *
-                        (30.0f - (15.0f * combined_momentum)); // Optimizacion
-
-                transfer_value +=
-                    static_cast<unsigned int>(operations * transfer_factor);
+                float transfer_factor = HeuristicFormula::transferFactor(
+                    strategy_weights, global_momentum,
+                    segment_matches[segment],
+                    std::min(SEGMENT_SIZE, size - segment * SEGMENT_SIZE));
+                transfer_value += HeuristicFormula::transferTerm(
+                    jugs[i], target_state.jugs[i], segment_max[segment],
+                    transfer_factor);
             }
         }
 
-        delete[] segment_matches;
-        delete[] segment_max;
-
-        // Normalizado por un maximo
-        unsigned int pattern_max = static_cast<unsigned int>(size * 25);
-        pattern_value =
-            pattern_max > pattern_value ? pattern_max - pattern_value : 0;
+        if (segment_matches != stack_counters) {
+            delete[] segment_matches;
+        }
 
-        // Penalizar por profundidad
-        float depth_penalty = std::min(
-            0.1f + (depth / (size * 3.0f)) * (0.8f + global_momentum), 0.3f);
-        // Peso final, ponderado cada heuristica considerando el momentum y la
-        // profundidad transfers pq pierde precision al final y no se prefiere
-        weight = static_cast<unsigned int>(
-            transfer_value * (1.5f + global_momentum) +
-            pattern_value * (1.0f - depth_penalty) +
-            depth * depth_penalty * (10.0f + 20.0f * global_momentum));
+        weight = HeuristicFormula::combine(transfer_value, pattern_value,
+                                           depth, matching_jugs, size);
 
         // Tracing
         TRACE_PLOT("State/Heuristic/PatternValue",
@@ -203,7 +161,9 @@ void State::calculateHeuristic(const State &target_state) {
         TRACE_PLOT("State/Heuristic/TransferValue",
                    static_cast<int64_t>(transfer_value));
         TRACE_PLOT("State/Heuristic/DepthPenalty",
-                   static_cast<int64_t>(depth_penalty * 100));
+                   static_cast<int64_t>(HeuristicFormula::depthPenalty(
+                                            depth, global_momentum, size) *
+                                        100));
         TRACE_PLOT("State/Heuristic/GlobalMomentum",
                    static_cast<int64_t>(global_momentum * 100));
         TRACE_PLOT("State/Heuristic/Weight", static_cast<int64_t>(weight));
@@ -216,10 +176,113 @@ void State::calculateHeuristic(const State &target_state) {
         heuristic_calculated = true;
     }
 }
+// cota admisible de movimientos restantes: un trasvase cambia dos jarras y
+// llenar o vaciar una sola, asi que cada movimiento arregla a lo mas dos
+unsigned int State::movesLowerBound(const State &target_state) const {
+    return (mismatchedJugs(target_state) + 1) / 2;
+}
+
+unsigned int State::mismatchedJugs(const State &target_state) const {
+    unsigned int mismatched = 0;
+    for (unsigned int i = 0; i < size; i++) {
+        if (jugs[i] != target_state.jugs[i]) {
+            mismatched++;
+        }
+    }
+    return mismatched;
+}
+
+unsigned int State::generateMoves(const unsigned int *capacities,
+                                  Move *moves) const {
+    unsigned int num_moves = 0;
+    for (unsigned int i = 0; i < size; i++) {
+        if (jugs[i] > 0) {
+            for (unsigned int j = 0; j < size; j++) {
+                if (i != j && jugs[j] < capacities[j]) {
+                    moves[num_moves++] = {Move::POUR, i, j};
+                }
+            }
+        }
+        if (jugs[i] < capacities[i]) {
+            moves[num_moves++] = {Move::FILL, i, i};
+        }
+        if (jugs[i] > 0) {
+            moves[num_moves++] = {Move::EMPTY, i, i};
+        }
+    }
+    return num_moves;
+}
+
+void State::applyMove(const Move &move, const unsigned int *capacities,
+                      unsigned int *new_jugs) const {
+    switch (move.type) {
+        case Move::FILL:
+            new_jugs[move.from] = capacities[move.from];
+            break;
+        case Move::EMPTY:
+            new_jugs[move.from] = 0;
+            break;
+        case Move::POUR: {
+            unsigned int amount =
+                std::min(jugs[move.from], capacities[move.to] - jugs[move.to]);
+            new_jugs[move.from] = jugs[move.from] - amount;
+            new_jugs[move.to] = jugs[move.to] + amount;
+            break;
+        }
+    }
+}
+
+uint16_t State::Move::code(unsigned int size) const {
+    switch (type) {
+        case FILL:
+            return static_cast<uint16_t>(from);
+        case EMPTY:
+            return static_cast<uint16_t>(size + from);
+        case POUR:
+            break;
+    }
+    return static_cast<uint16_t>(2 * size + from * size + to);
+}
+
+State::Move State::Move::fromCode(uint16_t code, unsigned int size) {
+    if (code < size) {
+        return {FILL, code, code};
+    }
+    if (code < 2 * size) {
+        return {EMPTY, code - size, code - size};
+    }
+    unsigned int pair = code - 2 * size;
+    return {POUR, pair / size, pair % size};
+}
+
+// solo cambian from y to, asi que basta comparar esas jarras antes y despues
+int State::mismatchDelta(const Move &move, const unsigned int *capacities,
+                         const State &target_state) const {
+    const unsigned int *target = target_state.jugs;
+    unsigned int from = move.from;
+    int before = jugs[from] != target[from];
+    switch (move.type) {
+        case Move::FILL:
+            return (capacities[from] != target[from]) - before;
+        case Move::EMPTY:
+            return (target[from] != 0) - before;
+        case Move::POUR: {
+            unsigned int to = move.to;
+            unsigned int amount =
+                std::min(jugs[from], capacities[to] - jugs[to]);
+            before += jugs[to] != target[to];
+            int after = (jugs[from] - amount != target[from]) +
+                        (jugs[to] + amount != target[to]);
+            return after - before;
+        }
+    }
+    return 0;
+}
 // generacion de suceros sin ningun filtro, se generan todos los posibles y se
-// agregan
+// agregan. Si se entrega un pool, los sucesores salen de el en vez de new
 State **State::generateSuccessors(const unsigned int *capacities,
-                                  unsigned int &num_successors) const {
+                                  unsigned int &num_successors,
+                                  StatePool *pool) const {
     TRACE_SCOPE;
     unsigned int max_successors = size * ((size - 1) + 2);
     State **successors = nullptr;
@@ -252,8 +315,7 @@ State **State::generateSuccessors(const unsigned int *capacities,
                     new_jugs[i] -= transfer_amount;
                     new_jugs[j] += transfer_amount;
                     successors[num_successors] =
-                        new State(size, new_jugs, depth + 1, 0,
-                                  const_cast<State *>(this));
+                        makeChild(new_jugs, pool, i, j);
                     num_successors++;
 
                     new_jugs[i] = original_i;
@@ -264,8 +326,7 @@ State **State::generateSuccessors(const unsigned int *capacities,
             // Fill
             if (new_jugs[i] < capacities[i]) {
                 new_jugs[i] = capacities[i];
-                successors[num_successors] = new State(
-                    size, new_jugs, depth + 1, 0, const_cast<State *>(this));
+                successors[num_successors] = makeChild(new_jugs, pool, i, i);
                 num_successors++;
                 new_jugs[i] = original_i;
             }
@@ -274,8 +335,7 @@ State **State::generateSuccessors(const unsigned int *capacities,
             if (new_jugs[i] > 0) {
                 new_jugs[i] = 0;
 
-                successors[num_successors] = new State(
-                    size, new_jugs, depth + 1, 0, const_cast<State *>(this));
+                successors[num_successors] = makeChild(new_jugs, pool, i, i);
                 num_successors++;
 
                 new_jugs[i] = original_i;
@@ -290,7 +350,11 @@ State **State::generateSuccessors(const unsigned int *capacities,
         // ejecucion
         if (successors) {
             for (unsigned int i = 0; i < num_successors; i++) {
-                delete successors[i];
+                if (pool) {
+                    pool->release(successors[i]);
+                } else {
+                    delete successors[i];
+                }
             }
             delete[] successors;
             successors = nullptr;
@@ -303,6 +367,115 @@ State **State::generateSuccessors(const unsigned int *capacities,
     }
 }
 
+// inverso de generateSuccessors: todos los estados desde los que un movimiento
+// llega a este. Llenar i deja cualquier valor menor a la capacidad, vaciar i
+// cualquier valor mayor a 0, y un trasvase i -> j de t solo pudo dejar i vacio
+// o j lleno. El parent de cada predecesor es este estado
+State **State::generatePredecessors(const unsigned int *capacities,
+                                    unsigned int &num_predecessors,
+                                    StatePool *pool) const {
+    TRACE_SCOPE;
+    unsigned int max_predecessors = 0;
+    for (unsigned int i = 0; i < size; i++) {
+        max_predecessors += capacities[i];
+        for (unsigned int j = 0; j < size; j++) {
+            if (i != j) {
+                max_predecessors +=
+                    std::min(jugs[j], capacities[i] - jugs[i]);
+            }
+        }
+    }
+
+    State **predecessors = nullptr;
+    unsigned int *new_jugs = nullptr;
+    num_predecessors = 0;
+
+    try {
+        predecessors = new State *[max_predecessors + 1]();
+        new_jugs = new unsigned int[size];
+        memcpy(new_jugs, jugs, size * sizeof(unsigned int));
+
+        for (unsigned int i = 0; i < size; i++) {
+            // Transfer i -> j que termino en este estado
+            for (unsigned int j = 0; j < size; j++) {
+                if (i == j ||
+                    (jugs[i] != 0 && jugs[j] != capacities[j])) {
+                    continue;
+                }
+                unsigned int max_amount =
+                    std::min(jugs[j], capacities[i] - jugs[i]);
+                for (unsigned int t = 1; t <= max_amount; t++) {
+                    new_jugs[i] = jugs[i] + t;
+                    new_jugs[j] = jugs[j] - t;
+                    predecessors[num_predecessors] =
+                        makeChild(new_jugs, pool, i, j);
+                    num_predecessors++;
+                }
+                new_jugs[i] = jugs[i];
+                new_jugs[j] = jugs[j];
+            }
+
+            // Fill
+            if (jugs[i] == capacities[i]) {
+                for (unsigned int v = 0; v < capacities[i]; v++) {
+                    new_jugs[i] = v;
+                    predecessors[num_predecessors] =
+                        makeChild(new_jugs, pool, i, i);
+                    num_predecessors++;
+                }
+                new_jugs[i] = jugs[i];
+            }
+
+            // Empty
+            if (jugs[i] == 0) {
+                for (unsigned int v = 1; v <= capacities[i]; v++) {
+                    new_jugs[i] = v;
+                    predecessors[num_predecessors] =
+                        makeChild(new_jugs, pool, i, i);
+                    num_predecessors++;
+                }
+                new_jugs[i] = jugs[i];
+            }
+        }
+        delete[] new_jugs;
+        return predecessors;
+
+    } catch (...) {
+        if (predecessors) {
+            for (unsigned int i = 0; i < num_predecessors; i++) {
+                if (pool) {
+                    pool->release(predecessors[i]);
+                } else {
+                    delete predecessors[i];
+                }
+            }
+            delete[] predecessors;
+        }
+        delete[] new_jugs;
+        throw;
+    }
+}
+
+State *State::makeChild(const unsigned int *new_jugs, StatePool *pool) const {
+    if (pool) {
+        return pool->allocate(new_jugs, depth + 1, 0,
+                              const_cast<State *>(this));
+    }
+    return new State(size, const_cast<unsigned int *>(new_jugs), depth + 1,
+                     0, const_cast<State *>(this));
+}
+
+State *State::makeChild(const unsigned int *new_jugs, StatePool *pool,
+                        unsigned int first, unsigned int second) const {
+    if (!pool || !pool->zobrist || !hashed) {
+        return makeChild(new_jugs, pool);
+    }
+    uint64_t child_hash =
+        pool->zobrist->childHash(hash, jugs, new_jugs, first, second);
+    return pool->allocate(new_jugs, depth + 1, 0, const_cast<State *>(this),
+                          child_hash);
+}
+
 void State::printState(const char *label) {
     cout << label << ": ";
     if (this->size == 0 || this->jugs == nullptr) {
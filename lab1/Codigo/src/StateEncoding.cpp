@@ -0,0 +1,65 @@
+#include "../include/StateEncoding.h"
+
+StateEncoding::StateEncoding(const unsigned int *capacities,
+                             unsigned int size) {
+    TRACE_SCOPE;
+    this->size = size;
+    this->bits = new unsigned int[size];
+    this->shifts = new unsigned int[size];
+    this->word_index = new unsigned int[size];
+
+    // se llena cada palabra de izquierda a derecha, si la jarra no cabe en lo
+    // que queda se pasa a la siguiente
+    unsigned int word = 0;
+    unsigned int used = 0;
+    for (unsigned int i = 0; i < size; i++) {
+        bits[i] = bitsFor(capacities[i]);
+        if (used + bits[i] > WORD_BITS) {
+            word++;
+            used = 0;
+        }
+        word_index[i] = word;
+        shifts[i] = used;
+        used += bits[i];
+    }
+    this->words = size > 0 ? word + 1 : 0;
+}
+
+StateEncoding::~StateEncoding() {
+    delete[] bits;
+    delete[] shifts;
+    delete[] word_index;
+}
+
+void StateEncoding::pack(const unsigned int *jugs, uint64_t *key) const {
+    for (unsigned int w = 0; w < words; w++) {
+        key[w] = 0;
+    }
+    for (unsigned int i = 0; i < size; i++) {
+        key[word_index[i]] |= static_cast<uint64_t>(jugs[i]) << shifts[i];
+    }
+}
+
+void StateEncoding::set(uint64_t *key, unsigned int jug,
+                        unsigned int value) const {
+    uint64_t mask = ((1ull << bits[jug]) - 1) << shifts[jug];
+    key[word_index[jug]] = (key[word_index[jug]] & ~mask) |
+                           (static_cast<uint64_t>(value) << shifts[jug]);
+}
+
+void StateEncoding::unpack(const uint64_t *key, unsigned int *jugs) const {
+    for (unsigned int i = 0; i < size; i++) {
+        uint64_t mask = (1ull << bits[i]) - 1;
+        jugs[i] =
+            static_cast<unsigned int>((key[word_index[i]] >> shifts[i]) & mask);
+    }
+}
+
+// bits necesarios para guardar valores entre 0 y capacity
+unsigned int StateEncoding::bitsFor(unsigned int capacity) {
+    unsigned int b = 1;
+    while (b < 32 && (capacity >> b) != 0) {
+        b++;
+    }
+    return b;
+}
@@ -0,0 +1,122 @@
+#include "../include/StatePool.h"
+#include <new>
+
+StatePool::StatePool(unsigned int jug_count, const StateEncoding *encoding,
+                     const ZobristHash *zobrist) {
+    TRACE_SCOPE;
+    this->jug_count = jug_count;
+    this->encoding = encoding;
+    this->zobrist = zobrist;
+    // la llave y el registro quedan alineados a 8 para que el siguiente State
+    // tambien lo este
+    size_t raw = sizeof(State) + jug_count * sizeof(unsigned int);
+    this->key_offset = (raw + 7) & ~static_cast<size_t>(7);
+    unsigned int words = encoding ? encoding->words : 0;
+    this->record_size = key_offset + words * sizeof(uint64_t);
+    this->slabs_capacity = INITIAL_SLABS;
+    this->slabs = new char *[slabs_capacity];
+    this->num_slabs = 0;
+    this->used_in_slab = STATES_PER_SLAB;
+    this->free_list = nullptr;
+    this->live_states = 0;
+}
+
+StatePool::~StatePool() {
+    TRACE_SCOPE;
+    clear();
+    delete[] slabs;
+}
+
+State *StatePool::allocate(const unsigned int *jugs, unsigned int depth,
+                           unsigned int weight, State *parent) {
+    TRACE_SCOPE;
+    State *state = place(jugs, depth, weight, parent);
+    if (zobrist) {
+        state->hash = zobrist->hashOf(jugs);
+        state->hashed = true;
+    }
+    return state;
+}
+
+State *StatePool::allocate(const unsigned int *jugs, unsigned int depth,
+                           unsigned int weight, State *parent, uint64_t hash) {
+    TRACE_SCOPE;
+    State *state = place(jugs, depth, weight, parent);
+    state->hash = hash;
+    state->hashed = true;
+    return state;
+}
+
+// Se reutiliza primero lo que este en la free list, sino se corta un registro
+// nuevo del slab actual. Las jarras quedan inline detras del State
+State *StatePool::place(const unsigned int *jugs, unsigned int depth,
+                        unsigned int weight, State *parent) {
+    char *record;
+    if (free_list) {
+        record = reinterpret_cast<char *>(free_list);
+        free_list = free_list->parent;
+    } else {
+        if (used_in_slab == STATES_PER_SLAB) {
+            addSlab();
+        }
+        record = slabs[num_slabs - 1] + used_in_slab * record_size;
+        used_in_slab++;
+    }
+
+    State *state = new (record) State();
+    state->size = jug_count;
+    state->jugs = reinterpret_cast<unsigned int *>(record + sizeof(State));
+    state->owns_jugs = false;
+    state->depth = depth;
+    state->weight = weight;
+    state->parent = parent;
+    memcpy(state->jugs, jugs, jug_count * sizeof(unsigned int));
+    if (encoding) {
+        state->key = reinterpret_cast<uint64_t *>(record + key_offset);
+        state->key_words = encoding->words;
+        encoding->pack(jugs, state->key);
+    }
+
+    live_states++;
+    TRACE_PLOT("StatePool/LiveStates", static_cast<int64_t>(live_states));
+    return state;
+}
+
+// el registro vuelve a la free list, se usa parent como enlace
+void StatePool::release(State *state) {
+    if (!state)
+        return;
+    state->parent = free_list;
+    free_list = state;
+    live_states--;
+}
+
+// State no tiene recursos propios cuando sus jarras son inline, asi que basta
+// con devolver los slabs
+void StatePool::clear() {
+    TRACE_SCOPE;
+    for (unsigned int i = 0; i < num_slabs; i++) {
+        delete[] slabs[i];
+    }
+    num_slabs = 0;
+    used_in_slab = STATES_PER_SLAB;
+    free_list = nullptr;
+    live_states = 0;
+}
+
+size_t StatePool::reservedBytes() const {
+    return static_cast<size_t>(num_slabs) * STATES_PER_SLAB * record_size +
+           slabs_capacity * sizeof(char *);
+}
+
+void StatePool::addSlab() {
+    if (num_slabs == slabs_capacity) {
+        char **bigger = new char *[slabs_capacity * 2];
+        memcpy(bigger, slabs, num_slabs * sizeof(char *));
+        delete[] slabs;
+        slabs = bigger;
+        slabs_capacity *= 2;
+    }
+    slabs[num_slabs++] = new char[record_size * STATES_PER_SLAB];
+    used_in_slab = 0;
+}
@@ -0,0 +1,258 @@
+#include "../include/SwissTable.h"
+
+SwissTable::SwissTable() {
+    this->size = 0;
+    this->tombstones = 0;
+    this->capacity = INITIAL_SIZE;
+    allocate();
+}
+
+SwissTable::~SwissTable() {
+    if (ctrl) {
+        cleanup();
+        delete[] ctrl_storage;
+        delete[] states;
+        ctrl = nullptr;
+        ctrl_storage = nullptr;
+        states = nullptr;
+    }
+}
+
+size_t SwissTable::reservedBytes() const {
+    return static_cast<size_t>(capacity) *
+               (sizeof(signed char) + sizeof(State *)) +
+           CACHE_LINE;
+}
+
+// los bytes de control quedan alineados a linea de cache, asi la carga de un
+// grupo nunca toca dos lineas
+void SwissTable::allocate() {
+    ctrl_storage = new signed char[capacity + CACHE_LINE];
+    uintptr_t address = reinterpret_cast<uintptr_t>(ctrl_storage);
+    ctrl = ctrl_storage + (CACHE_LINE - address % CACHE_LINE) % CACHE_LINE;
+    memset(ctrl, EMPTY, capacity);
+    states = new State *[capacity]();
+}
+
+// mascara de bits con los slots del grupo cuyo byte de control es value
+unsigned int SwissTable::matchMask(const signed char *group,
+                                   signed char value) {
+#if defined(__AVX2__)
+    __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(group));
+    return static_cast<unsigned int>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(g, _mm256_set1_epi8(value))));
+#elif defined(__SSE2__)
+    __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    return static_cast<unsigned int>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(value))));
+#else
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < GROUP_SIZE; i++) {
+        if (group[i] == value) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+// slots libres (EMPTY o DELETED), son los unicos con el bit de signo
+unsigned int SwissTable::freeMask(const signed char *group) {
+#if defined(__AVX2__)
+    return static_cast<unsigned int>(_mm256_movemask_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(group))));
+#elif defined(__SSE2__)
+    return static_cast<unsigned int>(_mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(group))));
+#else
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < GROUP_SIZE; i++) {
+        if (group[i] < 0) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+// se reutiliza el hash de 64 bits de HashTable, basta con 32
+unsigned int SwissTable::hashOf(const State *state) {
+    return static_cast<unsigned int>(HashTable::computeHash(state));
+}
+
+// el hash se divide en H1 (grupo de partida) y H2 (tag de 7 bits). Los grupos
+// se recorren con sondeo triangular, y un grupo con algun EMPTY termina la
+// busqueda
+long SwissTable::find(const State *state, unsigned int hash) const {
+    TRACE_SCOPE;
+    unsigned int group_mask = capacity / GROUP_SIZE - 1;
+    unsigned int group = (hash >> 7) & group_mask;
+    signed char tag = static_cast<signed char>(hash & 0x7F);
+
+    for (unsigned int step = 1;; step++) {
+        const signed char *base = ctrl + group * GROUP_SIZE;
+        // el slot depende de la mascara, se adelanta la carga de los punteros
+        // del grupo para no esperar dos fallos de cache seguidos
+        __builtin_prefetch(states + group * GROUP_SIZE);
+        unsigned int matches = matchMask(base, tag);
+        while (matches) {
+            unsigned int slot = group * GROUP_SIZE + __builtin_ctz(matches);
+            if (states[slot]->equals(state)) {
+                return slot;
+            }
+            matches &= matches - 1;
+        }
+        if (matchMask(base, EMPTY)) {
+            return -1;
+        }
+        if (step > group_mask) {
+            return -1;
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+bool SwissTable::contains(const State *state) const {
+    if (!state || !ctrl)
+        return false;
+    return find(state, hashOf(state)) >= 0;
+}
+
+// una sola pasada: se buscan duplicados y se recuerda el primer slot libre
+// de la secuencia, hasta llegar a un grupo con algun EMPTY
+bool SwissTable::insert(State *state) {
+    if (!state || !ctrl)
+        return false;
+
+    if (shouldResize()) {
+        // si son mas tumbas que datos basta con limpiar sin crecer
+        resize(tombstones > size ? capacity : capacity * 2);
+    }
+
+    unsigned int hash = hashOf(state);
+    unsigned int group_mask = capacity / GROUP_SIZE - 1;
+    unsigned int group = (hash >> 7) & group_mask;
+    signed char tag = static_cast<signed char>(hash & 0x7F);
+    long target = -1;
+
+    for (unsigned int step = 1;; step++) {
+        const signed char *base = ctrl + group * GROUP_SIZE;
+        __builtin_prefetch(states + group * GROUP_SIZE);
+        unsigned int matches = matchMask(base, tag);
+        while (matches) {
+            unsigned int slot = group * GROUP_SIZE + __builtin_ctz(matches);
+            if (states[slot]->equals(state)) {
+                return false;
+            }
+            matches &= matches - 1;
+        }
+        unsigned int free_slots = freeMask(base);
+        if (target < 0 && free_slots) {
+            target = group * GROUP_SIZE + __builtin_ctz(free_slots);
+        }
+        if (matchMask(base, EMPTY) || step > group_mask) {
+            break;
+        }
+        group = (group + step) & group_mask;
+    }
+
+    if (ctrl[target] == DELETED) {
+        tombstones--;
+    }
+    ctrl[target] = tag;
+    states[target] = state;
+    size++;
+    return true;
+}
+
+// se ubica en el primer slot libre (EMPTY o DELETED) de la secuencia, sin
+// revisar duplicados, lo usa resize
+void SwissTable::insertHashed(State *state, unsigned int hash) {
+    unsigned int group_mask = capacity / GROUP_SIZE - 1;
+    unsigned int group = (hash >> 7) & group_mask;
+    signed char tag = static_cast<signed char>(hash & 0x7F);
+
+    for (unsigned int step = 1;; step++) {
+        unsigned int free_slots = freeMask(ctrl + group * GROUP_SIZE);
+        if (free_slots) {
+            unsigned int slot = group * GROUP_SIZE + __builtin_ctz(free_slots);
+            if (ctrl[slot] == DELETED) {
+                tombstones--;
+            }
+            ctrl[slot] = tag;
+            states[slot] = state;
+            size++;
+            return;
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+// si el grupo todavia tiene un EMPTY ninguna busqueda pasa de largo, asi que
+// el slot puede quedar EMPTY en vez de tumba
+void SwissTable::removeState(State *state) {
+    if (!state || !ctrl)
+        return;
+
+    long slot = find(state, hashOf(state));
+    if (slot < 0) {
+        return;
+    }
+    const signed char *base = ctrl + (slot / GROUP_SIZE) * GROUP_SIZE;
+    if (matchMask(base, EMPTY)) {
+        ctrl[slot] = EMPTY;
+    } else {
+        ctrl[slot] = DELETED;
+        tombstones++;
+    }
+    states[slot] = nullptr;
+    size--;
+}
+
+void SwissTable::cleanup() {
+    if (!ctrl)
+        return;
+    for (unsigned int i = 0; i < capacity; i++) {
+        if (ctrl[i] >= 0 && states[i]) {
+            delete states[i];
+        }
+    }
+    clear();
+}
+
+// olvida las entradas sin liberar los estados
+void SwissTable::clear() {
+    if (!ctrl)
+        return;
+    memset(ctrl, EMPTY, capacity);
+    memset(states, 0, capacity * sizeof(State *));
+    size = 0;
+    tombstones = 0;
+}
+
+bool SwissTable::shouldResize() const {
+    return (static_cast<float>(size + tombstones + 1) / capacity) >=
+           MAX_LOAD_FACTOR;
+}
+
+void SwissTable::resize(unsigned int new_capacity) {
+    TRACE_SCOPE;
+    unsigned int old_capacity = capacity;
+    signed char *old_storage = ctrl_storage;
+    signed char *old_ctrl = ctrl;
+    State **old_states = states;
+
+    capacity = new_capacity;
+    allocate();
+    size = 0;
+    tombstones = 0;
+
+    for (unsigned int i = 0; i < old_capacity; i++) {
+        if (old_ctrl[i] >= 0) {
+            insertHashed(old_states[i], hashOf(old_states[i]));
+        }
+    }
+
+    delete[] old_storage;
+    delete[] old_states;
+}
@@ -0,0 +1,76 @@
+#include "../include/ZobristHash.h"
+
+ZobristHash::ZobristHash(const unsigned int *capacities, unsigned int size) {
+    TRACE_SCOPE;
+    this->size = size;
+    this->offsets = new size_t[size];
+    size_t total = 0;
+    for (unsigned int i = 0; i < size; i++) {
+        offsets[i] = total;
+        total += capacities[i] + static_cast<size_t>(1);
+    }
+
+    this->keys = nullptr;
+    if (total <= MAX_TABLE_ENTRIES) {
+        keys = new uint64_t[total];
+        for (unsigned int i = 0; i < size; i++) {
+            for (unsigned int v = 0; v <= capacities[i]; v++) {
+                keys[offsets[i] + v] = mixKey(i, v);
+            }
+        }
+    }
+}
+
+ZobristHash::~ZobristHash() {
+    delete[] keys;
+    delete[] offsets;
+}
+
+uint64_t ZobristHash::key(unsigned int jug, unsigned int value) const {
+    return keys ? keys[offsets[jug] + value] : mixKey(jug, value);
+}
+
+uint64_t ZobristHash::hashOf(const unsigned int *jugs) const {
+    uint64_t hash = 0;
+    for (unsigned int i = 0; i < size; i++) {
+        hash ^= key(i, jugs[i]);
+    }
+    return hash;
+}
+
+uint64_t ZobristHash::update(uint64_t hash, unsigned int jug,
+                             unsigned int old_value,
+                             unsigned int new_value) const {
+    return hash ^ key(jug, old_value) ^ key(jug, new_value);
+}
+
+uint64_t ZobristHash::childHash(uint64_t parent_hash,
+                               const unsigned int *parent_jugs,
+                               const unsigned int *child_jugs,
+                               unsigned int first, unsigned int second) const {
+    uint64_t hash =
+        update(parent_hash, first, parent_jugs[first], child_jugs[first]);
+    if (second != first) {
+        hash = update(hash, second, parent_jugs[second], child_jugs[second]);
+    }
+    return hash;
+}
+
+// finalizador de splitmix64 sobre (jarra, valor), cada bit de la entrada
+// cambia la mitad de los de la llave
+uint64_t ZobristHash::mixKey(unsigned int jug, unsigned int value) {
+    uint64_t k = (static_cast<uint64_t>(jug) << 32 | value) +
+                 0x9E3779B97F4A7C15ull;
+    k = (k ^ (k >> 30)) * 0xBF58476D1CE4E5B9ull;
+    k = (k ^ (k >> 27)) * 0x94D049BB133111EBull;
+    return k ^ (k >> 31);
+}
+
+uint64_t ZobristHash::computeFrom(const unsigned int *jugs,
+                                  unsigned int size) {
+    uint64_t hash = 0;
+    for (unsigned int i = 0; i < size; i++) {
+        hash ^= mixKey(i, jugs[i]);
+    }
+    return hash;
+}
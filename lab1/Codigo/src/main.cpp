@@ -1,11 +1,145 @@
 #include "../include/Solver.h"
 #include "../include/TracyMacros.h"
+#include "../test/test_AnytimeSearch.h"
+#include "../test/test_BidirectionalSearch.h"
+#include "../test/test_BucketQueue.h"
+#include "../test/test_CompactClosedSet.h"
+#include "../test/test_DenseSearch.h"
+#include "../test/test_ExternalSearch.h"
+#include "../test/test_FocalSearch.h"
+#include "../test/test_HDAStarSearch.h"
 #include "../test/test_HashTable.h"
+#include "../test/test_Heap.h"
+#include "../test/test_HeuristicContext.h"
+#include "../test/test_IDAStarSearch.h"
+#include "../test/test_PatternDatabase.h"
 #include "../test/test_Search.h"
+#include "../test/test_SearchLimits.h"
 #include "../test/test_Solver.h"
 #include "../test/test_State.h"
+#include "../test/test_StateEncoding.h"
+#include "../test/test_StatePool.h"
+#include "../test/test_SwissTable.h"
+#include "../test/test_ZobristHash.h"
 #include <iostream>
 
+// lectura de un numero dentro de [min, max], se repite hasta que sea valido
+static int readChoice(int min, int max) {
+    int choice;
+    while (!(std::cin >> choice) || choice < min || choice > max) {
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        std::cout << "Numero invalido, se debe seleccionar alguno entre ("
+                  << min << "-" << max << "): ";
+    }
+    return choice;
+}
+
+// submenu de opciones de la busqueda, se guardan en el solver
+static void configureSearch(Solver &solver) {
+    Search::Options options = solver.getSearchOptions();
+
+    const char *mode_names[] = {"heuristic",  "bidirectional", "IDA*",
+                                "optimal A*", "focal",         "anytime",
+                                "external BFS", "HDA*"};
+    std::cout << "\nSearch engine (actual: "
+              << mode_names[static_cast<int>(options.mode)] << ")\n";
+    std::cout << "1. Heuristic search\n";
+    std::cout << "2. Bidirectional BFS (optimal, small instances)\n";
+    std::cout << "3. IDA* (bounded memory)\n";
+    std::cout << "4. Optimal A* (shortest solution)\n";
+    std::cout << "5. Focal search (at most w times the shortest)\n";
+    std::cout << "6. Anytime (improves until a limit)\n";
+    std::cout << "7. External-memory BFS (layers on disk, shortest)\n";
+    std::cout << "8. Parallel A* (HDA*, shortest, all cores)\n";
+    std::cout << "Option: ";
+    options.mode = static_cast<SearchMode>(readChoice(1, 8) - 1);
+    if (options.mode == SearchMode::HEURISTIC) {
+        std::cout << "Heuristic evaluation (actual: "
+                  << (options.deferred_evaluation ? "deferred" : "eager")
+                  << ")\n";
+        std::cout << "1. On generation\n";
+        std::cout << "2. Deferred until popped\n";
+        std::cout << "Option: ";
+        options.deferred_evaluation = readChoice(1, 2) == 2;
+    }
+    if (options.mode == SearchMode::FOCAL) {
+        std::cout << "Suboptimality w in percent, 100-1000 (actual: "
+                  << static_cast<int>(options.suboptimality * 100 + 0.5f)
+                  << "): ";
+        options.suboptimality = readChoice(100, 1000) / 100.0f;
+    }
+    if (options.mode == SearchMode::OPTIMAL ||
+        options.mode == SearchMode::FOCAL ||
+        options.mode == SearchMode::ANYTIME) {
+        std::cout << "Pattern database bound (actual: "
+                  << (options.use_pdb ? "on" : "off") << ")\n";
+        std::cout << "1. Off\n";
+        std::cout << "2. On (cached in " << options.pdb_cache_dir << "/)\n";
+        std::cout << "Option: ";
+        options.use_pdb = readChoice(1, 2) == 2;
+    }
+    if (options.mode == SearchMode::OPTIMAL) {
+        std::cout << "Partial expansion, EPEA* (actual: "
+                  << (options.partial_expansion ? "on" : "off") << ")\n";
+        std::cout << "1. Off\n";
+        std::cout << "2. On (only children with the node's f)\n";
+        std::cout << "Option: ";
+        options.partial_expansion = readChoice(1, 2) == 2;
+    }
+    if (options.mode == SearchMode::IDA_STAR ||
+        options.mode == SearchMode::EXTERNAL) {
+        std::cout << "Memory budget in MB (actual: "
+                  << (options.memory_budget >> 20) << "): ";
+        options.memory_budget = static_cast<size_t>(readChoice(1, 1 << 20))
+                                << 20;
+    }
+    if (options.mode == SearchMode::HDA_STAR) {
+        std::cout << "Threads, 0 = all cores (actual: " << options.threads
+                  << "): ";
+        options.threads = readChoice(0, 256);
+    }
+
+    std::cout << "\nClosed set (actual: "
+              << ClosedSet::backendName(options.closed_backend) << ")\n";
+    std::cout << "1. Robin Hood\n";
+    std::cout << "2. Swiss table\n";
+    std::cout << "3. Compact records (path rebuilt at the end)\n";
+    std::cout << "Option: ";
+    int closed_choice = readChoice(1, 3);
+    options.closed_backend =
+        closed_choice == 3   ? ClosedSetBackend::COMPACT
+        : closed_choice == 2 ? ClosedSetBackend::SWISS
+                             : ClosedSetBackend::ROBIN_HOOD;
+
+    std::cout << "\nOpen list (actual: "
+              << OpenList::backendName(options.open_backend) << ")\n";
+    std::cout << "1. Pairing heap\n";
+    std::cout << "2. Bucket queue (LIFO)\n";
+    std::cout << "3. Bucket queue (FIFO)\n";
+    std::cout << "Option: ";
+    int open_choice = readChoice(1, 3);
+    options.open_backend = open_choice == 1 ? OpenListBackend::PAIRING_HEAP
+                                            : OpenListBackend::BUCKET_QUEUE;
+    options.tie_break = open_choice == 3 ? BucketQueue::TieBreak::FIFO
+                                         : BucketQueue::TieBreak::LIFO;
+
+    // topes de la busqueda, al pasarse se devuelve lo mejor que haya
+    SearchLimits &limits = options.limits;
+    std::cout << "\nLimits, 0 = none\n";
+    std::cout << "Time in ms (actual: " << limits.max_time_ms << "): ";
+    limits.max_time_ms = readChoice(0, 86400000);
+    std::cout << "Expansions (actual: " << limits.max_expansions << "): ";
+    limits.max_expansions = readChoice(0, 2000000000);
+    std::cout << "Live states (actual: " << limits.max_live_states << "): ";
+    limits.max_live_states = readChoice(0, 2000000000);
+    std::cout << "Memory in MB (actual: " << (limits.max_bytes >> 20)
+              << "): ";
+    limits.max_bytes = static_cast<size_t>(readChoice(0, 1 << 20)) << 20;
+
+    solver.setSearchOptions(options);
+}
+
 int main() {
     TRACE_SCOPE;
     Solver solver;
@@ -17,14 +151,15 @@ int main() {
         std::cout << "1. Read file\n";
         std::cout << "2. Solve\n";
         std::cout << "3. Run Tests\n";
-        std::cout << "4. Exit\n";
+        std::cout << "4. Search options\n";
+        std::cout << "5. Exit\n";
         std::cout << "Option: ";
 
         while (!(std::cin >> option)) {
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             std::cout
-                << "Numero invalido, se debe seleccionar alguno entre (1-4): ";
+                << "Numero invalido, se debe seleccionar alguno entre (1-5): ";
         }
 
         switch (option) {
@@ -60,17 +195,107 @@ int main() {
                     testHashTable();
                     std::cout << "\033[32mHashTable tests passed!\033[0m.\n";
 
+                    std::cout << "\033[1;31mProbando SwissTable..\033[0m.\n";
+                    testSwissTable();
+                    std::cout << "\033[32mSwissTable tests passed!\033[0m.\n";
+
+                    std::cout
+                        << "\033[1;31mTesting CompactClosedSet...\033[0m.\n";
+                    testCompactClosedSet();
+                    std::cout << "\033[32mCompactClosedSet tests "
+                                 "passed!\033[0m.\n";
+
+                    std::cout << "\033[1;31mTesting Heap...\033[0m.\n";
+                    testHeap();
+                    std::cout << "\033[32mHeap tests passed!\033[0m.\n";
+
+                    std::cout << "\033[1;31mTesting BucketQueue...\033[0m.\n";
+                    testBucketQueue();
+                    std::cout << "\033[32mBucketQueue tests passed!\033[0m.\n";
+
                     std::cout << "\033[1;31mTesting Search...\033[0m.\n";
                     testSearch();
                     std::cout << "\033[32mSearch tests passed!\033[0m.\n\n";
 
+                    std::cout << "\033[1;31mTesting DenseSearch...\033[0m.\n";
+                    testDenseSearch();
+                    std::cout
+                        << "\033[32mDenseSearch tests passed!\033[0m.\n\n";
+
+                    std::cout
+                        << "\033[1;31mTesting BidirectionalSearch...\033[0m.\n";
+                    testBidirectionalSearch();
+                    std::cout << "\033[32mBidirectionalSearch tests "
+                                 "passed!\033[0m.\n\n";
+
+                    std::cout << "\033[1;31mTesting IDAStarSearch...\033[0m.\n";
+                    testIDAStarSearch();
+                    std::cout
+                        << "\033[32mIDAStarSearch tests passed!\033[0m.\n\n";
+
+                    std::cout
+                        << "\033[1;31mTesting ExternalSearch...\033[0m.\n";
+                    testExternalSearch();
+                    std::cout << "\033[32mExternalSearch tests "
+                                 "passed!\033[0m.\n\n";
+
+                    std::cout
+                        << "\033[1;31mTesting HDAStarSearch...\033[0m.\n";
+                    testHDAStarSearch();
+                    std::cout
+                        << "\033[32mHDAStarSearch tests passed!\033[0m.\n\n";
+
+                    std::cout
+                        << "\033[1;31mTesting PatternDatabase...\033[0m.\n";
+                    testPatternDatabase();
+                    std::cout << "\033[32mPatternDatabase tests "
+                                 "passed!\033[0m.\n\n";
+
+                    std::cout << "\033[1;31mTesting FocalSearch...\033[0m.\n";
+                    testFocalSearch();
+                    std::cout
+                        << "\033[32mFocalSearch tests passed!\033[0m.\n\n";
+
+                    std::cout << "\033[1;31mTesting AnytimeSearch...\033[0m.\n";
+                    testAnytimeSearch();
+                    std::cout
+                        << "\033[32mAnytimeSearch tests passed!\033[0m.\n\n";
+
+                    std::cout << "\033[1;31mTesting SearchLimits...\033[0m.\n";
+                    testSearchLimits();
+                    std::cout
+                        << "\033[32mSearchLimits tests passed!\033[0m.\n\n";
+
                     std::cout << "\033[1;31mTesting Solver...\033[0m.\n\n";
                     testSolver();
                     std::cout << "\033[32mSolver tests passed!\033[0m.\n\n";
 
+                    std::cout
+                        << "\033[1;31mTesting HeuristicContext...\033[0m.\n";
+                    testHeuristicContext();
+                    std::cout << "\033[32mHeuristicContext tests "
+                                 "passed!\033[0m.\n\n";
+
                     std::cout << "\033[1;31mTesting State...\033[0m.\n\n";
                     testState();
                     std::cout << "\033[32mState tests passed!\033[0m.\n\n";
+
+                    std::cout << "\033[1;31mTesting StatePool...\033[0m.\n\n";
+                    testStatePool();
+                    std::cout
+                        << "\033[32mStatePool tests passed!\033[0m.\n\n";
+
+                    std::cout
+                        << "\033[1;31mTesting StateEncoding...\033[0m.\n\n";
+                    testStateEncoding();
+                    std::cout
+                        << "\033[32mStateEncoding tests passed!\033[0m.\n\n";
+
+                    std::cout
+                        << "\033[1;31mTesting ZobristHash...\033[0m.\n\n";
+                    testZobristHash();
+                    std::cout
+                        << "\033[32mZobristHash tests passed!\033[0m.\n\n";
                     std::cout << "----------------------\n";
                     std::cout << "\033[32mResuelto todos los test con "
                                  "exito!\033[0m.\n\n";
@@ -83,6 +308,12 @@ int main() {
             }
 
             case 4: {
+                TRACE_SCOPE;
+                configureSearch(solver);
+                break;
+            }
+
+            case 5: {
                 TRACE_SCOPE;
                 std::cout << "Exiting program...\n";
                 return 0;
@@ -90,7 +321,7 @@ int main() {
 
             default: {
                 TRACE_SCOPE;
-                std::cout << "Invalid option. Please select 1-4.\n";
+                std::cout << "Invalid option. Please select 1-5.\n";
                 break;
             }
         }
@@ -0,0 +1,47 @@
+#include "../include/AnytimeSearch.h"
+#include <cassert>
+
+inline void testAnytimeSearch() {
+    unsigned int capacities[3] = {3, 5, 7};
+    unsigned int zero[3] = {0, 0, 0};
+    unsigned int target[3] = {0, 0, 6};
+    State *initial_state = new State(3, zero, 0, 0, nullptr);
+    State *target_state = new State(3, target, 0, 0, nullptr);
+
+    // sin limites termina probando el optimo, y cada mejora es mas corta
+    Search::Options options;
+    options.mode = SearchMode::ANYTIME;
+    AnytimeSearch *search =
+        new AnytimeSearch(initial_state, target_state, capacities, options);
+    unsigned int improvements = 0;
+    unsigned int last_length = ~0u;
+    search->setImprovementCallback(
+        [&](const Search::Path &path, float) {
+            assert(path.length < last_length);
+            assert(path.states[path.length - 1]->equals(target_state));
+            last_length = path.length;
+            improvements++;
+        });
+    Search::Path path = search->findPath();
+    assert(improvements >= 1);
+    assert(search->proven_optimal);
+    assert(path.length == 5 && path.lower_bound == 4);
+    assert(path.states[0]->equals(initial_state));
+    Search::freePath(path);
+    delete search;
+
+    // con presupuesto de una expansion no alcanza a resolver
+    options.limits.max_expansions = 1;
+    AnytimeSearch *budget =
+        new AnytimeSearch(initial_state, target_state, capacities, options);
+    Search::Path none = budget->findPath();
+    assert(!budget->proven_optimal);
+    assert(none.stop_reason == StopReason::EXPANSIONS);
+    assert(none.length == 0 || none.states[none.length - 1]->equals(
+                                   target_state));
+    Search::freePath(none);
+    delete budget;
+
+    delete initial_state;
+    delete target_state;
+}
@@ -0,0 +1,67 @@
+#include "../include/BidirectionalSearch.h"
+#include <cassert>
+
+// b sale de a con un solo llenado, vaciado o trasvase
+inline bool isSingleMove(const State *a, const State *b,
+                         const unsigned int *capacities) {
+    unsigned int num_successors = 0;
+    State **successors = a->generateSuccessors(capacities, num_successors);
+    bool found = false;
+    for (unsigned int i = 0; i < num_successors; i++) {
+        found = found || successors[i]->equals(b);
+        delete successors[i];
+    }
+    delete[] successors;
+    return found;
+}
+
+inline void testBidirectionalSearch() {
+    unsigned int capacities[3] = {3, 5, 7};
+    unsigned int zero[3] = {0, 0, 0};
+    unsigned int target[3] = {0, 0, 6};
+    State *initial_state = new State(3, zero, 0, 0, nullptr);
+    State *target_state = new State(3, target, 0, 0, nullptr);
+
+    // cada predecesor tiene al estado como sucesor
+    unsigned int jugs[3] = {3, 0, 4};
+    State *state = new State(3, jugs, 0, 0, nullptr);
+    unsigned int num_predecessors = 0;
+    State **predecessors =
+        state->generatePredecessors(capacities, num_predecessors);
+    assert(num_predecessors > 0);
+    for (unsigned int i = 0; i < num_predecessors; i++) {
+        assert(isSingleMove(predecessors[i], state, capacities));
+        delete predecessors[i];
+    }
+    delete[] predecessors;
+    delete state;
+
+    // camino valido y optimo: {3,5,7} -> {0,0,6} en 4 movimientos
+    BidirectionalSearch *search =
+        new BidirectionalSearch(initial_state, target_state, capacities);
+    Search::Path path = search->findPath();
+    assert(path.length == 5);
+    assert(path.states[0]->equals(initial_state));
+    assert(path.states[path.length - 1]->equals(target_state));
+    for (unsigned int i = 0; i + 1 < path.length; i++) {
+        assert(isSingleMove(path.states[i], path.states[i + 1], capacities));
+    }
+    Search::freePath(path);
+    delete search;
+
+    // sin solucion: con {2,4} no se puede llegar a un impar
+    unsigned int even_capacities[2] = {2, 4};
+    unsigned int odd_target[2] = {0, 3};
+    State *even_start = new State(2, zero, 0, 0, nullptr);
+    State *odd_state = new State(2, odd_target, 0, 0, nullptr);
+    BidirectionalSearch *unsolvable =
+        new BidirectionalSearch(even_start, odd_state, even_capacities);
+    Search::Path none = unsolvable->findPath();
+    assert(none.length == 0);
+    delete unsolvable;
+    delete even_start;
+    delete odd_state;
+
+    delete initial_state;
+    delete target_state;
+}
@@ -0,0 +1,56 @@
+#include "../include/BucketQueue.h"
+#include <cassert>
+
+inline void testBucketQueue() {
+    unsigned int jugs[3] = {0, 0, 0};
+    State *s1 = new State(3, jugs, 0, 10, nullptr);
+    State *s2 = new State(3, jugs, 0, 5, nullptr);
+    State *s3 = new State(3, jugs, 0, 5, nullptr);
+    State *s4 = new State(3, jugs, 0, 5000, nullptr);
+
+    // LIFO: el ultimo con el menor peso sale primero
+    BucketQueue *lifo = new BucketQueue(BucketQueue::TieBreak::LIFO);
+    assert(lifo->empty());
+    lifo->push(s1);
+    lifo->push(s2);
+    lifo->push(s3);
+    lifo->push(s4);
+    assert(lifo->num_buckets > 5000);
+    assert(lifo->size == 4);
+    assert(lifo->peek() == s3);
+    assert(lifo->pop() == s3);
+    assert(lifo->pop() == s2);
+    // un peso menor que el cursor lo mueve hacia atras
+    lifo->push(s2);
+    assert(lifo->pop() == s2);
+    assert(lifo->pop() == s1);
+    assert(lifo->pop() == s4);
+    assert(lifo->empty());
+    assert(lifo->pop() == nullptr);
+    delete lifo;
+
+    // FIFO: en orden de llegada dentro del bucket
+    BucketQueue *fifo = new BucketQueue(BucketQueue::TieBreak::FIFO);
+    fifo->push(s2);
+    fifo->push(s3);
+    fifo->push(s1);
+    assert(fifo->pop() == s2);
+    assert(fifo->pop() == s3);
+    assert(fifo->pop() == s1);
+    // muchos en el mismo bucket, con compactacion de lo ya sacado
+    for (unsigned int i = 0; i < 100; i++) {
+        fifo->push(i % 2 ? s2 : s3);
+        if (i % 3 == 0) {
+            fifo->pop();
+        }
+    }
+    assert(fifo->size == 100 - 34);
+    fifo->clear();
+    assert(fifo->empty());
+    delete fifo;
+
+    delete s1;
+    delete s2;
+    delete s3;
+    delete s4;
+}
@@ -0,0 +1,78 @@
+#include "../include/CompactClosedSet.h"
+#include "../include/StatePool.h"
+#include <cassert>
+
+inline void testCompactClosedSet() {
+    CompactClosedSet *closed = new CompactClosedSet();
+    assert(closed->capacity == CompactClosedSet::INITIAL_SLOTS);
+
+    unsigned int capacities[3] = {7, 11, 13};
+    StateEncoding encoding(capacities, 3);
+    ZobristHash zobrist(capacities, 3);
+    StatePool pool(3, &encoding, &zobrist);
+    unsigned int jugs[3] = {4, 0, 0};
+    State *root = pool.allocate(jugs, 0, 0, nullptr);
+    State *same_state = pool.allocate(jugs, 2, 0, nullptr);
+
+    // insertar registra la llave, el padre y el movimiento
+    assert(closed->insert(root));
+    assert(root->node == 0);
+    assert(closed->parents[0] == State::NO_NODE);
+    assert(!closed->insert(same_state));
+    assert(closed->contains(same_state));
+    assert(closed->closedAs(root));
+    assert(!closed->closedAs(same_state));
+    assert(closed->size == 1 && closed->num_nodes == 1);
+
+    // un hijo registrado antes de cerrarse (EPEA) reutiliza su registro
+    unsigned int child_jugs[3] = {0, 4, 0};
+    State *child = pool.allocate(child_jugs, 1, 0, nullptr);
+    State::Move pour = {State::Move::POUR, 0, 1};
+    child->parent_node = root->node;
+    child->move_code = pour.code(3);
+    uint32_t node = closed->record(child);
+    assert(!closed->contains(child));
+    assert(closed->insert(child));
+    assert(child->node == node && closed->num_nodes == 2);
+    assert(closed->parents[node] == root->node);
+    assert(closed->moves[node] == pour.code(3));
+
+    // remover deja el registro, que puede ser padre de otros
+    closed->removeState(same_state);
+    assert(!closed->contains(root));
+    assert(closed->contains(child));
+    assert(closed->size == 1 && closed->num_nodes == 2);
+
+    // todos los estados de jarras 63, 63 y 31: crecen los registros y el
+    // indice sin perder ninguno, y se pueden sacar intercalados
+    closed->clear();
+    unsigned int big_capacities[3] = {63, 63, 31};
+    StateEncoding big_encoding(big_capacities, 3);
+    ZobristHash big_zobrist(big_capacities, 3);
+    StatePool big_pool(3, &big_encoding, &big_zobrist);
+    const unsigned int count = 64 * 64 * 32;
+    State **all = new State *[count];
+    unsigned int index = 0;
+    for (unsigned int a = 0; a <= 63; a++) {
+        for (unsigned int b = 0; b <= 63; b++) {
+            for (unsigned int c = 0; c <= 31; c++) {
+                unsigned int values[3] = {a, b, c};
+                all[index] = big_pool.allocate(values, 0, 0, nullptr);
+                assert(closed->insert(all[index]));
+                index++;
+            }
+        }
+    }
+    assert(closed->size == count && closed->num_nodes == count);
+    assert(closed->capacity > CompactClosedSet::INITIAL_SLOTS);
+    for (unsigned int i = 0; i < count; i += 2) {
+        closed->removeState(all[i]);
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        assert(closed->contains(all[i]) == (i % 2 == 1));
+    }
+    assert(closed->size == count / 2);
+    delete[] all;
+
+    delete closed;
+}
@@ -0,0 +1,155 @@
+#include "../include/DenseSearch.h"
+#include <cassert>
+
+inline void testDenseSearch() {
+    unsigned int capacities[3] = {3, 5, 7};
+    unsigned int zero[3] = {0, 0, 0};
+    unsigned int target[3] = {0, 0, 6};
+    State *initial_state = new State(3, zero, 0, 0, nullptr);
+    State *target_state = new State(3, target, 0, 0, nullptr);
+
+    // 4 * 6 * 8 estados
+    assert(DenseSearch::fits(capacities, 3, 192));
+    assert(!DenseSearch::fits(capacities, 3, 191));
+
+    // BFS: el camino mas corto, cada paso un movimiento valido
+    DenseSearch *search =
+        new DenseSearch(initial_state, target_state, capacities);
+    Search::Path path = search->findPath();
+    assert(path.stop_reason == StopReason::COMPLETED);
+    assert(path.length == 5);
+    assert(path.lower_bound == 4);
+    assert(path.states[0]->equals(initial_state));
+    assert(path.states[4]->equals(target_state));
+    for (unsigned int i = 1; i < path.length; i++) {
+        State::Move moves[3 * 4];
+        unsigned int num_moves =
+            path.states[i - 1]->generateMoves(capacities, moves);
+        bool legal = false;
+        for (unsigned int m = 0; m < num_moves && !legal; m++) {
+            unsigned int child[3];
+            memcpy(child, path.states[i - 1]->jugs, sizeof(child));
+            path.states[i - 1]->applyMove(moves[m], capacities, child);
+            legal = memcmp(child, path.states[i]->jugs, sizeof(child)) == 0;
+        }
+        assert(legal);
+        assert(path.states[i]->parent == path.states[i - 1]);
+    }
+    // solo los States del camino
+    assert(search->state_pool.live_states == path.length);
+    Search::freePath(path);
+
+    // una segunda corrida parte de cero
+    Search::Path again = search->findPath();
+    assert(again.length == 5);
+    Search::freePath(again);
+    delete search;
+
+    // objetivo fuera de las capacidades: se recorre todo y no hay camino
+    unsigned int too_big[3] = {0, 6, 0};
+    State *unreachable = new State(3, too_big, 0, 0, nullptr);
+    DenseSearch *impossible =
+        new DenseSearch(initial_state, unreachable, capacities);
+    Search::Path none = impossible->findPath();
+    assert(none.length == 0 && none.stop_reason == StopReason::COMPLETED);
+    delete impossible;
+    delete unreachable;
+
+    // cortado, lo ya recorrido por capas es cota del optimo
+    SearchLimits limits;
+    limits.max_expansions = 3;
+    DenseSearch *limited =
+        new DenseSearch(initial_state, target_state, capacities, limits);
+    Search::Path cut = limited->findPath();
+    assert(cut.stop_reason == StopReason::EXPANSIONS);
+    assert(cut.length == 0);
+    assert(cut.lower_bound >= 1 && cut.lower_bound <= 4);
+    delete limited;
+
+    // Search lo elige solo si el espacio cabe, en cualquier modo
+    Search *automatic = new Search(initial_state, target_state, capacities);
+    assert(automatic->dense);
+    Search::Path automatic_path = automatic->findPath();
+    assert(automatic_path.length == 5);
+    Search::freePath(automatic_path);
+    delete automatic;
+    Search::Options small_limit;
+    small_limit.dense_max_states = 100;
+    Search *hashed =
+        new Search(initial_state, target_state, capacities, small_limit);
+    assert(!hashed->dense);
+    delete hashed;
+
+    delete initial_state;
+    delete target_state;
+
+    // mismo largo que el A* optimo con HashTable en un espacio mas grande
+    unsigned int big_capacities[5] = {9, 10, 11, 12, 13};
+    unsigned int big_zero[5] = {0, 0, 0, 0, 0};
+    unsigned int big_target[5] = {1, 10, 3, 4, 0};
+    State *big_initial = new State(5, big_zero, 0, 0, nullptr);
+    State *big_target_state = new State(5, big_target, 0, 0, nullptr);
+    Search::Options optimal;
+    optimal.mode = SearchMode::OPTIMAL;
+    optimal.dense_max_states = 0;
+    Search *reference = new Search(big_initial, big_target_state,
+                                   big_capacities, optimal);
+    Search::Path reference_path = reference->findPath();
+    DenseSearch *big = new DenseSearch(big_initial, big_target_state,
+                                       big_capacities, SearchLimits(), 1);
+    Search::Path big_path = big->findPath();
+    assert(big_path.length > 0);
+    assert(big_path.length == reference_path.length);
+    assert(big_path.states[big_path.length - 1]->equals(big_target_state));
+
+    // con varios hilos las capas grandes se reparten: mismo largo, y sin
+    // objetivo alcanzable se visita exactamente lo mismo
+    DenseSearch *parallel = new DenseSearch(big_initial, big_target_state,
+                                            big_capacities, SearchLimits(), 4);
+    Search::Path parallel_path = parallel->findPath();
+    assert(parallel_path.length == big_path.length);
+    assert(parallel_path.states[0]->equals(big_initial));
+    assert(parallel_path.states[parallel_path.length - 1]->equals(
+        big_target_state));
+    for (unsigned int i = 1; i < parallel_path.length; i++) {
+        State::Move moves[5 * 6];
+        const State *previous = parallel_path.states[i - 1];
+        unsigned int num_moves = previous->generateMoves(big_capacities, moves);
+        bool legal = false;
+        for (unsigned int m = 0; m < num_moves && !legal; m++) {
+            unsigned int child[5];
+            memcpy(child, previous->jugs, sizeof(child));
+            previous->applyMove(moves[m], big_capacities, child);
+            legal = memcmp(child, parallel_path.states[i]->jugs,
+                           sizeof(child)) == 0;
+        }
+        assert(legal);
+    }
+    Search::freePath(parallel_path);
+    delete parallel;
+
+    unsigned int out_of_reach[5] = {1, 2, 3, 4, 5};
+    State *unreachable_big = new State(5, out_of_reach, 0, 0, nullptr);
+    size_t visited_by[2];
+    unsigned int thread_counts[2] = {1, 4};
+    for (unsigned int k = 0; k < 2; k++) {
+        DenseSearch *exhaustive =
+            new DenseSearch(big_initial, unreachable_big, big_capacities,
+                            SearchLimits(), thread_counts[k]);
+        Search::Path empty = exhaustive->findPath();
+        assert(empty.length == 0);
+        assert(empty.stop_reason == StopReason::COMPLETED);
+        visited_by[k] = exhaustive->queue_tail;
+        delete exhaustive;
+    }
+    assert(visited_by[0] == visited_by[1]);
+    assert(visited_by[0] > DenseSearch::PARALLEL_MIN_LEVEL);
+    delete unreachable_big;
+
+    Search::freePath(big_path);
+    Search::freePath(reference_path);
+    delete big;
+    delete reference;
+    delete big_initial;
+    delete big_target_state;
+}
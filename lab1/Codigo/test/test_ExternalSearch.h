@@ -0,0 +1,123 @@
+#include "../include/ExternalSearch.h"
+#include <cassert>
+#include <sys/stat.h>
+
+// cada paso del camino es un movimiento legal del anterior
+inline bool externalPathIsLegal(const Search::Path &path,
+                                const unsigned int *capacities) {
+    State::Move moves[64];
+    for (unsigned int i = 1; i < path.length; i++) {
+        const State *from = path.states[i - 1];
+        unsigned int num_moves = from->generateMoves(capacities, moves);
+        bool legal = false;
+        for (unsigned int m = 0; m < num_moves && !legal; m++) {
+            unsigned int jugs[8];
+            memcpy(jugs, from->jugs, from->size * sizeof(unsigned int));
+            from->applyMove(moves[m], capacities, jugs);
+            legal = memcmp(jugs, path.states[i]->jugs,
+                           from->size * sizeof(unsigned int)) == 0;
+        }
+        if (!legal) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void testExternalSearch() {
+    // el filtro nunca olvida lo agregado y casi no da falsos positivos
+    BloomFilter filter(1 << 12);
+    assert(filter.reservedBytes() == (1u << 12));
+    for (uint64_t i = 0; i < 1000; i++) {
+        filter.add(ExternalSearch::keyHash(&i, 1));
+    }
+    unsigned int false_positives = 0;
+    for (uint64_t i = 0; i < 2000; i++) {
+        bool present = filter.mayContain(ExternalSearch::keyHash(&i, 1));
+        if (i < 1000) {
+            assert(present);
+        } else if (present) {
+            false_positives++;
+        }
+    }
+    assert(false_positives < 100);
+    filter.clear();
+    uint64_t first = 0;
+    assert(!filter.mayContain(ExternalSearch::keyHash(&first, 1)));
+
+    unsigned int capacities[3] = {3, 5, 7};
+    unsigned int zero[3] = {0, 0, 0};
+    unsigned int target[3] = {0, 0, 6};
+    State *initial_state = new State(3, zero, 0, 0, nullptr);
+    State *target_state = new State(3, target, 0, 0, nullptr);
+
+    // el camino mas corto, igual que IDA* y el bidireccional
+    ExternalSearch *search =
+        new ExternalSearch(initial_state, target_state, capacities);
+    Search::Path path = search->findPath();
+    assert(path.stop_reason == StopReason::COMPLETED);
+    assert(path.length == 5);
+    assert(path.lower_bound == 4);
+    assert(path.states[0]->equals(initial_state));
+    assert(path.states[path.length - 1]->equals(target_state));
+    assert(externalPathIsLegal(path, capacities));
+    std::string layer_zero = search->layerPath(0);
+    assert(search->num_layers == 5);
+    assert(search->layers[0].size == 1);
+    Search::freePath(path);
+    delete search;
+    // los archivos se borran con el motor
+    struct stat info;
+    assert(stat(layer_zero.c_str(), &info) != 0);
+
+    // al cortarse por expansiones las capas completas son cota del optimo
+    SearchLimits limits;
+    limits.max_expansions = 3;
+    ExternalSearch *limited =
+        new ExternalSearch(initial_state, target_state, capacities,
+                           ExternalSearch::DEFAULT_MEMORY_BUDGET,
+                           ExternalSearch::DEFAULT_WORK_DIR, limits);
+    Search::Path cut = limited->findPath();
+    assert(cut.stop_reason == StopReason::EXPANSIONS);
+    assert(cut.length == 0);
+    assert(cut.lower_bound >= 1 && cut.lower_bound <= 4);
+    delete limited;
+
+    delete initial_state;
+    delete target_state;
+
+    // con el buffer minimo cada capa sale de varias corridas y ocupa varios
+    // bloques; el largo es el del A* optimo
+    unsigned int big_capacities[5] = {9, 10, 11, 12, 13};
+    unsigned int big_zero[5] = {0, 0, 0, 0, 0};
+    unsigned int big_target[5] = {1, 10, 3, 4, 0};
+    State *big_initial = new State(5, big_zero, 0, 0, nullptr);
+    State *big_target_state = new State(5, big_target, 0, 0, nullptr);
+
+    Search::Options optimal;
+    optimal.mode = SearchMode::OPTIMAL;
+    optimal.dense_max_states = 0;
+    Search *reference = new Search(big_initial, big_target_state,
+                                   big_capacities, optimal);
+    Search::Path reference_path = reference->findPath();
+    assert(reference_path.length > 0);
+
+    ExternalSearch *small =
+        new ExternalSearch(big_initial, big_target_state, big_capacities, 1);
+    assert(small->run_capacity == ExternalSearch::BLOCK_KEYS);
+    Search::Path small_path = small->findPath();
+    assert(small_path.length == reference_path.length);
+    assert(small_path.states[0]->equals(big_initial));
+    assert(small_path.states[small_path.length - 1]->equals(big_target_state));
+    assert(externalPathIsLegal(small_path, big_capacities));
+    assert(small->layers[small->num_layers - 2].num_fences > 1);
+    assert(small->disk_probes > 0);
+    assert(small->bloom_skips > 0);
+    Search::freePath(small_path);
+    delete small;
+
+    Search::freePath(reference_path);
+    delete reference;
+    delete big_initial;
+    delete big_target_state;
+}
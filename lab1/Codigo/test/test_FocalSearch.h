@@ -0,0 +1,35 @@
+#include "../include/FocalSearch.h"
+#include <cassert>
+
+inline void testFocalSearch() {
+    unsigned int capacities[3] = {3, 5, 7};
+    unsigned int zero[3] = {0, 0, 0};
+    unsigned int target[3] = {0, 0, 6};
+    State *initial_state = new State(3, zero, 0, 0, nullptr);
+    State *target_state = new State(3, target, 0, 0, nullptr);
+
+    // con w = 1 es optimo; con w mayor el largo respeta la cota
+    float factors[3] = {1.0f, 1.5f, 3.0f};
+    for (float w : factors) {
+        Search::Options options;
+        options.mode = SearchMode::FOCAL;
+        options.suboptimality = w;
+        FocalSearch *search = new FocalSearch(initial_state, target_state,
+                                              capacities, options);
+        Search::Path path = search->findPath();
+        assert(path.length > 0);
+        assert(path.states[0]->equals(initial_state));
+        assert(path.states[path.length - 1]->equals(target_state));
+        unsigned int moves = path.length - 1;
+        assert(moves <= static_cast<unsigned int>(4 * w + 1e-4f));
+        assert(path.lower_bound <= 4 && path.lower_bound * w + 1e-4f >= moves);
+        if (w == 1.0f) {
+            assert(moves == 4);
+        }
+        Search::freePath(path);
+        delete search;
+    }
+
+    delete initial_state;
+    delete target_state;
+}
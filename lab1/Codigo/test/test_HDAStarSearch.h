@@ -0,0 +1,116 @@
+#include "../include/HDAStarSearch.h"
+#include <cassert>
+
+// cada paso del camino es un movimiento legal del anterior
+inline bool hdaPathIsLegal(const Search::Path &path,
+                           const unsigned int *capacities) {
+    State::Move moves[64];
+    for (unsigned int i = 1; i < path.length; i++) {
+        const State *from = path.states[i - 1];
+        unsigned int num_moves = from->generateMoves(capacities, moves);
+        bool legal = false;
+        for (unsigned int m = 0; m < num_moves && !legal; m++) {
+            unsigned int jugs[8];
+            memcpy(jugs, from->jugs, from->size * sizeof(unsigned int));
+            from->applyMove(moves[m], capacities, jugs);
+            legal = memcmp(jugs, path.states[i]->jugs,
+                           from->size * sizeof(unsigned int)) == 0;
+        }
+        if (!legal || path.states[i]->parent != from) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void testHDAStarSearch() {
+    unsigned int capacities[3] = {3, 5, 7};
+    unsigned int zero[3] = {0, 0, 0};
+    unsigned int target[3] = {0, 0, 6};
+    State *initial_state = new State(3, zero, 0, 0, nullptr);
+    State *target_state = new State(3, target, 0, 0, nullptr);
+
+    // el camino mas corto con cualquier cantidad de hilos
+    unsigned int thread_counts[3] = {1, 2, 4};
+    for (unsigned int k = 0; k < 3; k++) {
+        HDAStarSearch *search = new HDAStarSearch(
+            initial_state, target_state, capacities, thread_counts[k]);
+        assert(search->num_threads == thread_counts[k]);
+        Search::Path path = search->findPath();
+        assert(path.stop_reason == StopReason::COMPLETED);
+        assert(path.length == 5);
+        assert(path.lower_bound == 4);
+        assert(path.states[0]->equals(initial_state));
+        assert(path.states[4]->equals(target_state));
+        assert(hdaPathIsLegal(path, capacities));
+        assert(search->work.load() == 0);
+        Search::freePath(path);
+
+        // una segunda corrida parte de cero
+        Search::Path again = search->findPath();
+        assert(again.length == 5);
+        Search::freePath(again);
+        delete search;
+    }
+
+    // cortado, el menor f pendiente es cota del optimo. Con un hilo el tope
+    // se ve apenas pasa; con mas depende de cuando publican los otros
+    SearchLimits limits;
+    limits.max_expansions = 1;
+    HDAStarSearch *limited = new HDAStarSearch(initial_state, target_state,
+                                               capacities, 1, limits);
+    Search::Path cut = limited->findPath();
+    assert(cut.stop_reason == StopReason::EXPANSIONS);
+    assert(cut.lower_bound >= 1 && cut.lower_bound <= 4);
+    Search::freePath(cut);
+    delete limited;
+
+    delete initial_state;
+    delete target_state;
+
+    // mismo largo que el A* optimo de un hilo en un espacio mas grande
+    unsigned int big_capacities[5] = {9, 10, 11, 12, 13};
+    unsigned int big_zero[5] = {0, 0, 0, 0, 0};
+    unsigned int big_target[5] = {1, 10, 3, 4, 0};
+    State *big_initial = new State(5, big_zero, 0, 0, nullptr);
+    State *big_target_state = new State(5, big_target, 0, 0, nullptr);
+    Search::Options optimal;
+    optimal.mode = SearchMode::OPTIMAL;
+    optimal.dense_max_states = 0;
+    Search *reference = new Search(big_initial, big_target_state,
+                                   big_capacities, optimal);
+    Search::Path reference_path = reference->findPath();
+    assert(reference_path.length > 0);
+
+    HDAStarSearch *parallel = new HDAStarSearch(big_initial, big_target_state,
+                                                big_capacities, 4);
+    Search::Path parallel_path = parallel->findPath();
+    assert(parallel_path.stop_reason == StopReason::COMPLETED);
+    assert(parallel_path.length == reference_path.length);
+    assert(parallel_path.states[0]->equals(big_initial));
+    assert(parallel_path.states[parallel_path.length - 1]->equals(
+        big_target_state));
+    assert(hdaPathIsLegal(parallel_path, big_capacities));
+    // los estados se repartieron entre los hilos
+    for (unsigned int t = 0; t < 4; t++) {
+        assert(parallel->workers[t].stored > 0);
+    }
+    Search::freePath(parallel_path);
+    delete parallel;
+
+    // objetivo inalcanzable: se agota todo y no hay camino
+    unsigned int out_of_reach[5] = {1, 2, 3, 4, 5};
+    State *unreachable = new State(5, out_of_reach, 0, 0, nullptr);
+    HDAStarSearch *exhaustive = new HDAStarSearch(
+        big_initial, unreachable, big_capacities, 3);
+    Search::Path none = exhaustive->findPath();
+    assert(none.length == 0);
+    assert(none.stop_reason == StopReason::COMPLETED);
+    delete exhaustive;
+    delete unreachable;
+
+    Search::freePath(reference_path);
+    delete reference;
+    delete big_initial;
+    delete big_target_state;
+}
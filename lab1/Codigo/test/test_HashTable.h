@@ -1,4 +1,5 @@
 #include "../include/HashTable.h"
+#include "../include/StatePool.h"
 #include <cassert>
 
 inline void testHashTable() {
@@ -6,22 +7,31 @@ inline void testHashTable() {
 
     HashTable *ht = new HashTable();
 
-    assert(ht->capacity == HashTable::INITIAL_SIZE);
-    assert(ht->buckets->occupied == false);
-    assert(ht->buckets->state == nullptr);
-    assert(ht->buckets->psl == 0);
+    assert(ht->table.capacity == HashTable::INITIAL_SIZE);
+    assert(ht->table.buckets->occupied == false);
+    assert(ht->table.states[0] == nullptr);
+    assert(ht->table.buckets->psl == 0);
+    assert(sizeof(HashTable::Bucket) == 8);
+    assert(!ht->migrating());
 
     unsigned int *test_jugs = new unsigned int[3]{4, 0, 0};
     State *test_state = new State(3, test_jugs, 0, 0, nullptr);
 
     // computar hash
-    unsigned int stateHash = ht->computeHash(test_state);
+    uint64_t stateHash = ht->computeHash(test_state);
 
     assert(stateHash != 0);
 
     bool insertar = ht->insert(test_state);
     assert(insertar);
 
+    // la huella queda guardada junto a la metadata
+    size_t home = stateHash & (ht->table.capacity - 1);
+    assert(ht->table.buckets[home].occupied);
+    assert(HashTable::storedHash(ht->table.buckets[home]) ==
+           (stateHash & 0xFFFFFFFFFFull));
+    assert(ht->table.states[home] == test_state);
+
     // duplicado
     bool insertar2 = ht->insert(test_state);
     assert(!insertar2);
@@ -35,4 +45,37 @@ inline void testHashTable() {
     delete ht;
     delete test_state;
     delete[] test_jugs;
+
+    // crecimiento incremental: tabla chica y pocos buckets migrados por
+    // operacion, ambas tablas deben responder mientras dura la migracion
+    HashTable::Config config;
+    config.initial_capacity = 16;
+    config.migrate_step = 2;
+    HashTable *small = new HashTable(config);
+    unsigned int capacities[3] = {9, 9, 9};
+    StateEncoding encoding(capacities, 3);
+    StatePool pool(3, &encoding);
+    State *inserted[1000];
+    bool saw_migration = false;
+    for (unsigned int i = 0; i < 1000; i++) {
+        unsigned int values[3] = {i % 10, (i / 10) % 10, i / 100};
+        inserted[i] = pool.allocate(values, 0, 0, nullptr);
+        assert(small->insert(inserted[i]));
+        saw_migration = saw_migration || small->migrating();
+        assert(small->contains(inserted[i / 2]));
+        assert(!small->insert(inserted[i / 3]));
+    }
+    assert(saw_migration);
+    assert(small->size == 1000);
+    for (unsigned int i = 0; i < 1000; i += 2) {
+        small->removeState(inserted[i]);
+    }
+    assert(small->size == 500);
+    for (unsigned int i = 0; i < 1000; i++) {
+        assert(small->contains(inserted[i]) == (i % 2 == 1));
+    }
+    small->finishResize();
+    assert(!small->migrating());
+    small->clear();
+    delete small;
 }
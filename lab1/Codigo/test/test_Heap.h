@@ -4,13 +4,16 @@
 inline void testHeap() {
     PairingHeap *heap = new PairingHeap();
     assert(heap->empty());
-    assert(heap->size == PairingHeap::INITIAL_CAPACITY);
+    assert(heap->size == 0);
 
     // agregar elementos con distinto peso para ver si se ordenan por prioridad
     // al sacarlos
-    State *s1 = new State(3, new unsigned int[3]{4, 0, 0}, 0, 10, nullptr);
-    State *s2 = new State(3, new unsigned int[3]{0, 4, 0}, 0, 5, nullptr);
-    State *s3 = new State(3, new unsigned int[3]{0, 0, 4}, 0, 15, nullptr);
+    unsigned int jugs1[3] = {4, 0, 0};
+    unsigned int jugs2[3] = {0, 4, 0};
+    unsigned int jugs3[3] = {0, 0, 4};
+    State *s1 = new State(3, jugs1, 0, 10, nullptr);
+    State *s2 = new State(3, jugs2, 0, 5, nullptr);
+    State *s3 = new State(3, jugs3, 0, 15, nullptr);
     heap->push(s1);
     heap->push(s2);
     heap->push(s3);
@@ -24,6 +27,50 @@ inline void testHeap() {
 
     assert(heap->empty());
 
+    // decreaseKey y erase con los handles
+    PairingHeap::Handle h1 = heap->push(s1);
+    PairingHeap::Handle h2 = heap->push(s2);
+    PairingHeap::Handle h3 = heap->push(s3);
+    heap->decreaseKey(h3, 1);
+    assert(heap->peek() == s3);
+    heap->erase(h2);
+    assert(heap->size == 2);
+    // subir la llave lo manda al fondo, con el mismo handle
+    heap->decreaseKey(h3, 20);
+    assert(h3->state == s3 && h3->key == 20);
+    heap->decreaseKey(h3, 2);
+    assert(heap->peek() == s3);
+    heap->decreaseKey(h3, 20);
+    assert(heap->pop() == s1);
+    assert(heap->pop() == s3);
+    assert(heap->empty());
+    (void)h1;
+
+    // subir la llave de la raiz: sus hijos quedan en el heap
+    heap->push(s1);
+    PairingHeap::Handle top = heap->push(s2);
+    heap->push(s3);
+    heap->decreaseKey(top, 30);
+    assert(heap->size == 3);
+    assert(heap->pop() == s1);
+    assert(heap->pop() == s3);
+    assert(heap->pop() == s2);
+
+    // muchos hermanos bajo la raiz: el merge iterativo no debe usar la pila
+    for (unsigned int i = 0; i < 200000; i++) {
+        heap->push(i % 2 ? s1 : s3);
+    }
+    heap->push(s2);
+    assert(heap->pop() == s2);
+    unsigned int last = 0;
+    for (unsigned int i = 0; i < 1000; i++) {
+        State *s = heap->pop();
+        assert(s->weight >= last);
+        last = s->weight;
+    }
+    heap->clear();
+    assert(heap->empty());
+
     delete heap;
     delete s1;
     delete s2;
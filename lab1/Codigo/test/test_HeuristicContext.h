@@ -0,0 +1,53 @@
+#include "../include/HeuristicContext.h"
+#include <cassert>
+#include <random>
+
+inline void testHeuristicContext() {
+    std::mt19937 rng(42);
+    State::AdaptiveParams saved_params = State::adaptive_params;
+
+    // el peso completo y el de cada hijo salen iguales a calculateHeuristic,
+    // con tamanos que cortan segmentos y con los ajustes adaptativos
+    for (unsigned int round = 0; round < 200; round++) {
+        unsigned int size = 2 + rng() % 30;
+        unsigned int *capacities = new unsigned int[size];
+        unsigned int *target = new unsigned int[size];
+        unsigned int *jugs = new unsigned int[size];
+        for (unsigned int i = 0; i < size; i++) {
+            capacities[i] = 1 + rng() % 60;
+            target[i] = rng() % (capacities[i] + 1);
+            jugs[i] = rng() % 3 == 0 ? target[i] : rng() % (capacities[i] + 1);
+        }
+        State::adaptive_params.consecutive_improvements = rng() % 6;
+        State::adaptive_params.plateaus = rng() % 5;
+
+        State target_state(size, target, 0, 0, nullptr);
+        State parent(size, jugs, rng() % 80, 0, nullptr);
+        parent.calculateHeuristic(target_state);
+        HeuristicContext context(target_state, capacities);
+        assert(context.weightOf(parent) == parent.weight);
+
+        context.load(parent);
+        State::Move *moves = new State::Move[size * (size + 1)];
+        unsigned int num_moves = parent.generateMoves(capacities, moves);
+        unsigned int num_successors = 0;
+        State **successors =
+            parent.generateSuccessors(capacities, num_successors);
+        assert(num_moves == num_successors);
+        for (unsigned int k = 0; k < num_successors; k++) {
+            successors[k]->calculateHeuristic(target_state);
+            assert(context.childWeight(moves[k]) == successors[k]->weight);
+            delete successors[k];
+        }
+        // childWeight deja la copia del padre como estaba
+        assert(memcmp(context.jugs, parent.jugs,
+                      size * sizeof(unsigned int)) == 0);
+
+        delete[] successors;
+        delete[] moves;
+        delete[] capacities;
+        delete[] target;
+        delete[] jugs;
+    }
+    State::adaptive_params = saved_params;
+}
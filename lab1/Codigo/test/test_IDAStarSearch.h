@@ -0,0 +1,38 @@
+#include "../include/IDAStarSearch.h"
+#include <cassert>
+
+inline void testIDAStarSearch() {
+    unsigned int capacities[3] = {3, 5, 7};
+    unsigned int zero[3] = {0, 0, 0};
+    unsigned int target[3] = {0, 0, 6};
+    State *initial_state = new State(3, zero, 0, 0, nullptr);
+    State *target_state = new State(3, target, 0, 0, nullptr);
+
+    // la cota nunca pasa el numero de jarras distintas
+    State *full = new State(3, capacities, 0, 0, nullptr);
+    assert(full->movesLowerBound(*target_state) == 2);
+    assert(target_state->movesLowerBound(*target_state) == 0);
+    delete full;
+
+    // con cota admisible el camino es el optimo, igual que el bidireccional
+    IDAStarSearch *search =
+        new IDAStarSearch(initial_state, target_state, capacities);
+    Search::Path path = search->findPath();
+    assert(path.length == 5);
+    assert(path.states[0]->equals(initial_state));
+    assert(path.states[path.length - 1]->equals(target_state));
+    Search::freePath(path);
+    delete search;
+
+    // con un presupuesto minimo la tabla no crece, pero igual se resuelve
+    IDAStarSearch *tight =
+        new IDAStarSearch(initial_state, target_state, capacities, 1);
+    Search::Path tight_path = tight->findPath();
+    assert(tight->max_transpositions == 0);
+    assert(tight_path.length == 5);
+    Search::freePath(tight_path);
+    delete tight;
+
+    delete initial_state;
+    delete target_state;
+}
@@ -0,0 +1,143 @@
+#include "../include/MixedRadix.h"
+#include "../include/PatternDatabase.h"
+#include "../include/Search.h"
+#include "../include/State.h"
+#include <cassert>
+#include <cstdio>
+
+inline void testMixedRadix() {
+    unsigned int capacities[3] = {3, 5, 7};
+    MixedRadix radix(capacities, 3);
+    assert(radix.total == 4 * 6 * 8);
+    unsigned int values[3] = {2, 5, 1};
+    uint64_t index = radix.index(values);
+    assert(index == 2 + 5 * 4 + 1 * 24);
+    unsigned int decoded[3];
+    radix.decode(index, decoded);
+    assert(decoded[0] == 2 && decoded[1] == 5 && decoded[2] == 1);
+    assert(MixedRadix::spaceSize(capacities, 3) == radix.total);
+    unsigned int huge[3] = {0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu};
+    assert(MixedRadix::spaceSize(huge, 3) == 0);
+}
+
+inline void testPatternDatabase() {
+    testMixedRadix();
+
+    // con 3 jarras chicas hay un solo patron con todas, asi que la PDB es la
+    // distancia exacta: se compara con un BFS hacia atras sobre State
+    unsigned int capacities[3] = {3, 5, 7};
+    unsigned int target[3] = {0, 0, 6};
+    const char *dir = "pdb_test_cache";
+    PatternDatabase *pdb = new PatternDatabase(capacities, target, 3, dir);
+    assert(pdb->num_patterns == 1);
+    assert(!pdb->loaded_from_cache);
+    assert(pdb->lookup(target) == 0);
+
+    MixedRadix radix(capacities, 3);
+    unsigned char *distance = new unsigned char[radix.total];
+    memset(distance, PatternDatabase::UNREACHABLE, radix.total);
+    State **queue = new State *[radix.total];
+    unsigned int head = 0;
+    unsigned int tail = 0;
+    queue[tail++] = new State(3, target, 0, 0, nullptr);
+    distance[radix.index(target)] = 0;
+    while (head < tail) {
+        State *current = queue[head++];
+        unsigned int num_predecessors = 0;
+        State **predecessors =
+            current->generatePredecessors(capacities, num_predecessors);
+        for (unsigned int i = 0; i < num_predecessors; i++) {
+            uint64_t index = radix.index(predecessors[i]->jugs);
+            if (distance[index] == PatternDatabase::UNREACHABLE) {
+                distance[index] = distance[radix.index(current->jugs)] + 1;
+                predecessors[i]->parent = nullptr;
+                queue[tail++] = predecessors[i];
+            } else {
+                delete predecessors[i];
+            }
+        }
+        delete[] predecessors;
+    }
+    unsigned int values[3];
+    for (uint64_t index = 0; index < radix.total; index++) {
+        radix.decode(index, values);
+        assert(pdb->lookup(values) == distance[index]);
+    }
+
+    // la segunda vez se mapea el archivo
+    PatternDatabase *cached = new PatternDatabase(capacities, target, 3, dir);
+    assert(cached->loaded_from_cache);
+    for (uint64_t index = 0; index < radix.total; index++) {
+        radix.decode(index, values);
+        assert(cached->lookup(values) == pdb->lookup(values));
+    }
+    std::string path = cached->cache_path;
+    delete cached;
+    delete pdb;
+    std::remove(path.c_str());
+    std::remove(dir);
+
+    // con varios patrones sigue siendo cota inferior de la distancia real
+    unsigned int big_caps[5] = {60, 61, 62, 63, 64};
+    unsigned int big_target[5] = {0, 0, 0, 0, 5};
+    PatternDatabase *split = new PatternDatabase(big_caps, big_target, 5, "");
+    assert(split->num_patterns == 2);
+    assert(split->lookup(big_target) == 0);
+    unsigned int zero[5] = {0, 0, 0, 0, 0};
+    unsigned int bound = split->lookup(zero);
+    assert(bound >= 1 && bound <= 2);
+    delete split;
+
+    // con 510 jarras distintas movesLowerBound ya pasa de UNREACHABLE, pero
+    // llenar cada una resuelve: solo la PDB decide si es un callejon. Las
+    // jarras grandes no caben en ningun patron
+    const unsigned int MANY = 512;
+    unsigned int *many_caps = new unsigned int[MANY];
+    unsigned int *many_zero = new unsigned int[MANY]();
+    unsigned int *many_target = new unsigned int[MANY];
+    many_caps[0] = 3;
+    many_caps[1] = 5;
+    many_target[0] = 0;
+    many_target[1] = 5;
+    for (unsigned int i = 2; i < MANY; i++) {
+        many_caps[i] = 1u << 21;
+        many_target[i] = many_caps[i];
+    }
+    State *many_start = new State(MANY, many_zero, 0, 0, nullptr);
+    State *many_goal = new State(MANY, many_target, 0, 0, nullptr);
+    Search::Options with_pdb;
+    with_pdb.mode = SearchMode::OPTIMAL;
+    with_pdb.use_pdb = true;
+    with_pdb.pdb_cache_dir = "";
+    Search *wide = new Search(many_start, many_goal, many_caps, with_pdb);
+    assert(wide->pdb->num_patterns == 1);
+    assert(wide->start_state->lower_bound >= PatternDatabase::UNREACHABLE);
+    assert(!wide->isDeadEnd(wide->start_state));
+    delete wide;
+    delete many_goal;
+    delete many_start;
+    delete[] many_target;
+    delete[] many_zero;
+    delete[] many_caps;
+
+    // con un solo patron la PDB es exacta: ninguna jarra vacia ni llena no se
+    // alcanza, y eso si es un callejon
+    unsigned int stuck_target[3] = {1, 2, 3};
+    unsigned int small_zero[3] = {0, 0, 0};
+    State *small_start = new State(3, small_zero, 0, 0, nullptr);
+    State *stuck_goal = new State(3, stuck_target, 0, 0, nullptr);
+    with_pdb.dense_max_states = 0;
+    Search *stuck = new Search(small_start, stuck_goal, capacities, with_pdb);
+    assert(stuck->isDeadEnd(stuck->start_state));
+    Search::Path none = stuck->findPath();
+    assert(none.length == 0);
+    delete stuck;
+    delete stuck_goal;
+    delete small_start;
+
+    for (unsigned int i = 0; i < tail; i++) {
+        delete queue[i];
+    }
+    delete[] queue;
+    delete[] distance;
+}
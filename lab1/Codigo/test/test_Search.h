@@ -19,8 +19,12 @@ inline void testSearch() {
         initial_state = new State(3, initial_jugs, 0, 0, nullptr);
         target_state = new State(3, target_jugs, 0, 0, nullptr);
 
-        // Create and execute search
-        search = new Search(initial_state, target_state, max_capacities);
+        // Create and execute search. El espacio es chico, asi que sin
+        // dense_max_states = 0 todas resolverian con DenseSearch
+        Search::Options hashed_options;
+        hashed_options.dense_max_states = 0;
+        search = new Search(initial_state, target_state, max_capacities,
+                            hashed_options);
         Search::Path path = search->findPath();
 
         // Verify solution
@@ -30,6 +34,141 @@ inline void testSearch() {
         // Clean up path
         Search::freePath(path);
 
+        // mismo problema con el closed set Swiss table
+        Search::Options options = hashed_options;
+        options.closed_backend = ClosedSetBackend::SWISS;
+        Search *swiss_search =
+            new Search(initial_state, target_state, max_capacities, options);
+        Search::Path swiss_path = swiss_search->findPath();
+        assert(swiss_path.length > 0);
+        assert(swiss_path.states[swiss_path.length - 1]->equals(target_state));
+        Search::freePath(swiss_path);
+        delete swiss_search;
+
+        // open list con bucket queue
+        Search::Options bucket_options = hashed_options;
+        bucket_options.open_backend = OpenListBackend::BUCKET_QUEUE;
+        Search *bucket_search = new Search(initial_state, target_state,
+                                           max_capacities, bucket_options);
+        Search::Path bucket_path = bucket_search->findPath();
+        assert(bucket_path.length > 0);
+        assert(
+            bucket_path.states[bucket_path.length - 1]->equals(target_state));
+        Search::freePath(bucket_path);
+        delete bucket_search;
+
+        // evaluacion diferida, con ambas open lists
+        Search::Options deferred_options[2] = {hashed_options,
+                                               hashed_options};
+        deferred_options[1].open_backend = OpenListBackend::BUCKET_QUEUE;
+        for (Search::Options &deferred_option : deferred_options) {
+            deferred_option.deferred_evaluation = true;
+            Search *deferred = new Search(initial_state, target_state,
+                                          max_capacities, deferred_option);
+            Search::Path deferred_path = deferred->findPath();
+            assert(deferred_path.length > 0);
+            assert(deferred_path.states[deferred_path.length - 1]->equals(
+                target_state));
+            Search::freePath(deferred_path);
+            delete deferred;
+        }
+
+        // modo optimo: el camino mas corto es de 4 movimientos, con ambas
+        // open lists y con o sin expansion parcial. La parcial no crea mas
+        // estados que la completa
+        Search::Options optimal_options[4];
+        size_t live_states[4];
+        for (unsigned int k = 0; k < 4; k++) {
+            Search::Options &optimal_option = optimal_options[k];
+            optimal_option.dense_max_states = 0;
+            optimal_option.mode = SearchMode::OPTIMAL;
+            if (k % 2 == 1) {
+                optimal_option.open_backend = OpenListBackend::BUCKET_QUEUE;
+            }
+            optimal_option.partial_expansion = k >= 2;
+            Search *optimal = new Search(initial_state, target_state,
+                                         max_capacities, optimal_option);
+            Search::Path optimal_path = optimal->findPath();
+            assert(optimal_path.length == 5);
+            assert(optimal_path.states[4]->equals(target_state));
+            live_states[k] = optimal->state_pool.live_states;
+            Search::freePath(optimal_path);
+            delete optimal;
+        }
+        assert(live_states[2] <= live_states[0]);
+        assert(live_states[3] <= live_states[1]);
+
+        // closed set compacto: los cerrados vuelven al pool y el camino se
+        // rehace con los movimientos de los registros. Cada paso es un
+        // movimiento valido, y en modo optimo el largo sigue siendo 4
+        Search::Options compact_options[5];
+        compact_options[1].deferred_evaluation = true;
+        compact_options[2].open_backend = OpenListBackend::BUCKET_QUEUE;
+        compact_options[3].mode = SearchMode::OPTIMAL;
+        compact_options[4].mode = SearchMode::OPTIMAL;
+        compact_options[4].partial_expansion = true;
+        compact_options[4].open_backend = OpenListBackend::BUCKET_QUEUE;
+        for (unsigned int k = 0; k < 5; k++) {
+            compact_options[k].closed_backend = ClosedSetBackend::COMPACT;
+            compact_options[k].dense_max_states = 0;
+            Search *compact = new Search(initial_state, target_state,
+                                         max_capacities, compact_options[k]);
+            Search::Path compact_path = compact->findPath();
+            assert(compact_path.length > 0);
+            assert(compact_path.states[0]->equals(initial_state));
+            assert(compact_path.states[compact_path.length - 1]->equals(
+                target_state));
+            for (unsigned int i = 1; i < compact_path.length; i++) {
+                State *previous = compact_path.states[i - 1];
+                State::Move moves[3 * 4];
+                unsigned int num_moves =
+                    previous->generateMoves(max_capacities, moves);
+                bool legal = false;
+                for (unsigned int m = 0; m < num_moves && !legal; m++) {
+                    unsigned int child[3];
+                    memcpy(child, previous->jugs, sizeof(child));
+                    previous->applyMove(moves[m], max_capacities, child);
+                    legal = memcmp(child, compact_path.states[i]->jugs,
+                                   sizeof(child)) == 0;
+                }
+                assert(legal);
+            }
+            if (k >= 3) {
+                assert(compact_path.length == 5);
+                assert(compact_path.lower_bound == 4);
+                // sin contar los estados que se crearon al rehacer el camino
+                size_t replayed = compact_path.length - 1;
+                assert(compact->state_pool.live_states - replayed <
+                       live_states[k == 3 ? 0 : 3]);
+            }
+            Search::freePath(compact_path);
+            delete compact;
+        }
+
+        // open guarda una sola copia por configuracion, la menos profunda
+        Search::Options dedup_options[2] = {hashed_options, hashed_options};
+        dedup_options[1].open_backend = OpenListBackend::BUCKET_QUEUE;
+        for (Search::Options &dedup_option : dedup_options) {
+            Search *dedup = new Search(initial_state, target_state,
+                                       max_capacities, dedup_option);
+            unsigned int jugs[3] = {3, 0, 0};
+            State *deep = dedup->state_pool.allocate(jugs, 4, 10, nullptr);
+            State *shallow = dedup->state_pool.allocate(jugs, 1, 12, nullptr);
+            State *worse = dedup->state_pool.allocate(jugs, 6, 1, nullptr);
+            dedup->pushOpen(deep);
+            dedup->pushOpen(shallow);
+            dedup->pushOpen(worse);
+            assert(dedup->open_index.size == 1);
+            assert(dedup->open_duplicates == 2);
+            State *popped = nullptr;
+            while (!popped && !dedup->open_list.empty()) {
+                popped = dedup->popOpen();
+            }
+            assert(popped && popped->depth == 1);
+            assert(dedup->open_index.size == 0);
+            delete dedup;
+        }
+
         // Clean up everything else
         delete search;
         delete initial_state;
@@ -0,0 +1,115 @@
+#include "../include/BidirectionalSearch.h"
+#include "../include/FocalSearch.h"
+#include "../include/IDAStarSearch.h"
+#include "../include/Search.h"
+#include "../include/SearchLimits.h"
+#include <cassert>
+
+inline void testSearchLimits() {
+    // sin topes nunca corta
+    LimitGovernor free_governor((SearchLimits()));
+    for (unsigned int i = 0; i < 1000; i++) {
+        assert(!free_governor.exceeded(i, i, i));
+    }
+    assert(free_governor.reason == StopReason::COMPLETED);
+
+    // cada contador con su motivo, y una vez pasado queda pasado
+    SearchLimits limits;
+    limits.max_expansions = 10;
+    limits.max_live_states = 100;
+    limits.max_bytes = 1000;
+    LimitGovernor expansions(limits);
+    assert(!expansions.exceeded(9, 100, 1000));
+    assert(expansions.exceeded(10, 0, 0));
+    assert(expansions.reason == StopReason::EXPANSIONS);
+    assert(expansions.exceeded(0, 0, 0));
+    LimitGovernor live(limits);
+    assert(live.exceeded(0, 101, 0));
+    assert(live.reason == StopReason::LIVE_STATES);
+    LimitGovernor bytes(limits);
+    assert(bytes.exceeded(0, 0, 1001));
+    assert(bytes.reason == StopReason::MEMORY);
+
+    // la bandera ya se mira en la primera llamada
+    std::atomic<bool> cancel(true);
+    SearchLimits cancelled;
+    cancelled.cancel = &cancel;
+    LimitGovernor cancel_governor(cancelled);
+    assert(cancel_governor.exceeded(0, 0, 0));
+    assert(cancel_governor.reason == StopReason::CANCELLED);
+
+    unsigned int capacities[3] = {3, 5, 7};
+    unsigned int zero[3] = {0, 0, 0};
+    unsigned int target[3] = {0, 0, 6};
+    State *initial_state = new State(3, zero, 0, 0, nullptr);
+    State *target_state = new State(3, target, 0, 0, nullptr);
+
+    // cortada, la busqueda heuristica devuelve el camino al mejor estado
+    Search::Options options;
+    options.dense_max_states = 0;
+    options.limits.max_expansions = 1;
+    Search *search =
+        new Search(initial_state, target_state, capacities, options);
+    Search::Path path = search->findPath();
+    assert(path.stop_reason == StopReason::EXPANSIONS);
+    assert(path.length >= 1 && path.states[0]->equals(initial_state));
+    assert(path.lower_bound == 0);
+    Search::freePath(path);
+    delete search;
+
+    // en modo optimo ademas el menor f de open queda como cota
+    Search::Options optimal_options = options;
+    optimal_options.mode = SearchMode::OPTIMAL;
+    Search *optimal_search =
+        new Search(initial_state, target_state, capacities, optimal_options);
+    Search::Path optimal_path = optimal_search->findPath();
+    assert(optimal_path.stop_reason == StopReason::EXPANSIONS);
+    assert(optimal_path.lower_bound >= 1 && optimal_path.lower_bound <= 4);
+    Search::freePath(optimal_path);
+    delete optimal_search;
+
+    options.limits = cancelled;
+    Search *cancelled_search =
+        new Search(initial_state, target_state, capacities, options);
+    Search::Path cancelled_path = cancelled_search->findPath();
+    assert(cancelled_path.stop_reason == StopReason::CANCELLED);
+    Search::freePath(cancelled_path);
+    delete cancelled_search;
+
+    // IDA* cortado no tiene camino, pero el umbral queda como cota
+    SearchLimits one_expansion;
+    one_expansion.max_expansions = 1;
+    IDAStarSearch *ida =
+        new IDAStarSearch(initial_state, target_state, capacities,
+                          IDAStarSearch::DEFAULT_MEMORY_BUDGET,
+                          one_expansion);
+    Search::Path ida_path = ida->findPath();
+    assert(ida_path.length == 0 && ida_path.lower_bound >= 1);
+    assert(ida_path.stop_reason == StopReason::EXPANSIONS);
+    Search::freePath(ida_path);
+    delete ida;
+
+    options.limits = SearchLimits();
+    options.limits.max_live_states = 1;
+    FocalSearch *focal =
+        new FocalSearch(initial_state, target_state, capacities, options);
+    Search::Path focal_path = focal->findPath();
+    assert(focal_path.length == 0);
+    assert(focal_path.stop_reason == StopReason::LIVE_STATES);
+    Search::freePath(focal_path);
+    delete focal;
+
+    SearchLimits one_byte;
+    one_byte.max_bytes = 1;
+    BidirectionalSearch *bidirectional = new BidirectionalSearch(
+        initial_state, target_state, capacities,
+        BidirectionalSearch::DEFAULT_MAX_STATES, one_byte);
+    Search::Path bidirectional_path = bidirectional->findPath();
+    assert(bidirectional_path.length == 0);
+    assert(bidirectional_path.stop_reason == StopReason::MEMORY);
+    Search::freePath(bidirectional_path);
+    delete bidirectional;
+
+    delete initial_state;
+    delete target_state;
+}
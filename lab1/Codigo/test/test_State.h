@@ -51,6 +51,29 @@ inline void testState() {
             assert(succs[i]->parent == s2);
         }
 
+        // los movimientos siguen el orden de los sucesores, y mismatchDelta
+        // coincide con contar las jarras distintas del hijo
+        State::Move moves[3 * 4];
+        unsigned int num_moves = s2->generateMoves(capacities, moves);
+        assert(num_moves == num_succs);
+        for (unsigned int k = 0; k < num_moves; k++) {
+            unsigned int child_jugs[3];
+            memcpy(child_jugs, s2->jugs, sizeof(child_jugs));
+            s2->applyMove(moves[k], capacities, child_jugs);
+            assert(memcmp(child_jugs, succs[k]->jugs, sizeof(child_jugs)) ==
+                   0);
+            int delta =
+                static_cast<int>(succs[k]->mismatchedJugs(*different_state)) -
+                static_cast<int>(s2->mismatchedJugs(*different_state));
+            assert(s2->mismatchDelta(moves[k], capacities, *different_state) ==
+                   delta);
+            // el codigo de dos bytes devuelve el mismo movimiento
+            State::Move decoded =
+                State::Move::fromCode(moves[k].code(3), 3);
+            assert(decoded.type == moves[k].type &&
+                   decoded.from == moves[k].from && decoded.to == moves[k].to);
+        }
+
         // Clean up successors
         for (unsigned int i = 0; i < num_succs; i++) {
             delete succs[i];
@@ -0,0 +1,52 @@
+#include "../include/StateEncoding.h"
+#include "../include/StatePool.h"
+#include <cassert>
+
+inline void testStateEncoding() {
+    // capacidades de profe5, 83 bits en total -> 2 palabras
+    unsigned int capacities[17] = {3,  5,  7,  11, 13, 17, 19, 23, 29,
+                                   31, 37, 41, 43, 47, 53, 59, 61};
+    StateEncoding encoding(capacities, 17);
+    assert(StateEncoding::bitsFor(61) == 6);
+    assert(StateEncoding::bitsFor(64) == 7);
+    assert(StateEncoding::bitsFor(3) == 2);
+    assert(encoding.words == 2);
+
+    // ida y vuelta
+    unsigned int jugs[17] = {2,  4,  7,  0,  13, 16, 18, 22, 28,
+                             30, 36, 40, 42, 46, 52, 58, 61};
+    uint64_t key[2];
+    unsigned int back[17];
+    encoding.pack(jugs, key);
+    encoding.unpack(key, back);
+    for (unsigned int i = 0; i < 17; i++) {
+        assert(back[i] == jugs[i]);
+    }
+
+    // cambiar un campo da la misma llave que empaquetar de nuevo, sin tocar
+    // los vecinos
+    uint64_t repacked[2];
+    for (unsigned int i = 0; i < 17; i++) {
+        unsigned int saved = jugs[i];
+        jugs[i] = capacities[i] - saved;
+        encoding.set(key, i, jugs[i]);
+        encoding.pack(jugs, repacked);
+        assert(key[0] == repacked[0] && key[1] == repacked[1]);
+        jugs[i] = saved;
+        encoding.set(key, i, saved);
+    }
+    encoding.unpack(key, back);
+    for (unsigned int i = 0; i < 17; i++) {
+        assert(back[i] == jugs[i]);
+    }
+
+    // estados del pool comparan por llave
+    StatePool pool(17, &encoding);
+    State *a = pool.allocate(jugs, 0, 0, nullptr);
+    State *b = pool.allocate(jugs, 3, 0, nullptr);
+    jugs[16] = 60;
+    State *c = pool.allocate(jugs, 0, 0, nullptr);
+    assert(a->key != nullptr && a->key_words == 2);
+    assert(a->equals(b));
+    assert(!a->equals(c));
+}
@@ -0,0 +1,43 @@
+#include "../include/StatePool.h"
+#include <cassert>
+
+inline void testStatePool() {
+    StatePool *pool = new StatePool(3);
+    unsigned int jugs[3] = {1, 2, 3};
+
+    // registro con las jarras inline
+    State *s1 = pool->allocate(jugs, 1, 7, nullptr);
+    assert(s1->size == 3);
+    assert(s1->owns_jugs == false);
+    assert(s1->jugs == reinterpret_cast<unsigned int *>(s1 + 1));
+    assert(s1->jugs[0] == 1 && s1->jugs[1] == 2 && s1->jugs[2] == 3);
+    assert(s1->depth == 1 && s1->weight == 7);
+    assert(pool->live_states == 1);
+
+    // sucesores desde el pool
+    unsigned int capacities[3] = {4, 3, 5};
+    unsigned int num_succs = 0;
+    State **succs = s1->generateSuccessors(capacities, num_succs, pool);
+    assert(num_succs > 0);
+    for (unsigned int i = 0; i < num_succs; i++) {
+        assert(succs[i]->parent == s1);
+        assert(succs[i]->owns_jugs == false);
+        pool->release(succs[i]);
+    }
+    delete[] succs;
+    assert(pool->live_states == 1);
+
+    // un registro liberado se reutiliza
+    pool->release(s1);
+    State *s2 = pool->allocate(jugs, 0, 0, nullptr);
+    assert(s2 != nullptr);
+    assert(pool->live_states == 1);
+
+    // suficientes estados para pedir mas de un slab
+    for (unsigned int i = 0; i < StatePool::STATES_PER_SLAB + 10; i++) {
+        pool->allocate(jugs, i, 0, nullptr);
+    }
+    assert(pool->num_slabs >= 2);
+
+    delete pool;
+}
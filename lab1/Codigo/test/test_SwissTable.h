@@ -0,0 +1,95 @@
+#include "../include/StatePool.h"
+#include "../include/SwissTable.h"
+#include <cassert>
+
+inline void testSwissTable() {
+    SwissTable *table = new SwissTable();
+    assert(table->capacity == SwissTable::INITIAL_SIZE);
+    assert(table->capacity % SwissTable::GROUP_SIZE == 0);
+    assert(table->ctrl[0] == SwissTable::EMPTY);
+
+    unsigned int capacities[3] = {7, 11, 13};
+    StateEncoding encoding(capacities, 3);
+    StatePool pool(3, &encoding);
+    unsigned int jugs[3] = {4, 0, 0};
+    State *test_state = pool.allocate(jugs, 0, 0, nullptr);
+    State *same_state = pool.allocate(jugs, 2, 0, nullptr);
+
+    // insertar y duplicado
+    assert(table->insert(test_state));
+    assert(!table->insert(same_state));
+    assert(table->contains(same_state));
+    assert(table->size == 1);
+
+    // remover
+    table->removeState(same_state);
+    assert(!table->contains(test_state));
+    assert(table->size == 0);
+
+    // todos los estados posibles (8*12*14), sin perder ninguno
+    for (unsigned int a = 0; a <= 7; a++) {
+        for (unsigned int b = 0; b <= 11; b++) {
+            for (unsigned int c = 0; c <= 13; c++) {
+                unsigned int values[3] = {a, b, c};
+                assert(table->insert(pool.allocate(values, 0, 0, nullptr)));
+            }
+        }
+    }
+    assert(table->size == 8 * 12 * 14);
+    assert(table->contains(test_state));
+
+    table->clear();
+    delete table;
+
+    // casi al factor de carga, grupos llenos dejan DELETED al remover
+    unsigned int big_capacities[3] = {63, 63, 31};
+    StateEncoding big_encoding(big_capacities, 3);
+    StatePool big_pool(3, &big_encoding);
+    const unsigned int filled = 57000;
+    const unsigned int total = 65536;
+    State **states = new State *[total];
+    for (unsigned int i = 0; i < total; i++) {
+        unsigned int values[3] = {i % 64, (i / 64) % 64, i / 4096};
+        states[i] = big_pool.allocate(values, 0, 0, nullptr);
+    }
+
+    table = new SwissTable();
+    for (unsigned int i = 0; i < filled; i++) {
+        assert(table->insert(states[i]));
+    }
+    assert(table->capacity == SwissTable::INITIAL_SIZE);
+
+    // remover uno por medio
+    for (unsigned int i = 0; i < filled; i += 2) {
+        table->removeState(states[i]);
+    }
+    assert(table->size == filled / 2);
+    assert(table->tombstones > 0);
+    for (unsigned int i = 0; i < filled; i++) {
+        assert(table->contains(states[i]) == (i % 2 == 1));
+    }
+
+    // reinsertar reusa los slots borrados sin crecer
+    unsigned int tombstones = table->tombstones;
+    for (unsigned int i = 0; i < filled; i += 2) {
+        assert(table->insert(states[i]));
+    }
+    assert(table->size == filled);
+    assert(table->tombstones < tombstones);
+    assert(table->capacity == SwissTable::INITIAL_SIZE);
+
+    // pasar el factor de carga obliga a crecer y limpia los DELETED
+    for (unsigned int i = filled; i < total; i++) {
+        assert(table->insert(states[i]));
+    }
+    assert(table->capacity == 2 * SwissTable::INITIAL_SIZE);
+    assert(table->tombstones == 0);
+    assert(table->size == total);
+    for (unsigned int i = 0; i < total; i++) {
+        assert(table->contains(states[i]));
+    }
+
+    delete[] states;
+    table->clear();
+    delete table;
+}
@@ -0,0 +1,61 @@
+#include "../include/HashTable.h"
+#include "../include/StatePool.h"
+#include "../include/ZobristHash.h"
+#include <cassert>
+
+inline void testZobristHash() {
+    unsigned int capacities[5] = {3, 5, 8, 13, 21};
+    StateEncoding encoding(capacities, 5);
+    ZobristHash zobrist(capacities, 5);
+    assert(zobrist.keys != nullptr);
+    assert(zobrist.key(3, 7) == ZobristHash::mixKey(3, 7));
+
+    // el pool pone el hash, igual al calculado desde cero
+    StatePool pool(5, &encoding, &zobrist);
+    unsigned int jugs[5] = {0, 5, 2, 13, 9};
+    State *root = pool.allocate(jugs, 0, 0, nullptr);
+    assert(root->hashed);
+    assert(root->hash == ZobristHash::computeFrom(jugs, 5));
+    assert(HashTable::computeHash(root) == root->hash);
+
+    // cada sucesor y predecesor lo saca del padre
+    unsigned int num_successors = 0;
+    State **successors =
+        root->generateSuccessors(capacities, num_successors, &pool);
+    assert(num_successors > 0);
+    for (unsigned int k = 0; k < num_successors; k++) {
+        assert(successors[k]->hashed);
+        assert(successors[k]->hash ==
+               ZobristHash::computeFrom(successors[k]->jugs, 5));
+        // el mismo estado con new tiene el mismo hash
+        State copy(5, successors[k]->jugs, 0, 0, nullptr);
+        assert(!copy.hashed);
+        assert(HashTable::computeHash(&copy) == successors[k]->hash);
+    }
+    delete[] successors;
+    unsigned int num_predecessors = 0;
+    State **predecessors =
+        root->generatePredecessors(capacities, num_predecessors, &pool);
+    for (unsigned int k = 0; k < num_predecessors; k++) {
+        assert(predecessors[k]->hash ==
+               ZobristHash::computeFrom(predecessors[k]->jugs, 5));
+    }
+    delete[] predecessors;
+
+    // en la tabla se encuentran estados del pool y sueltos por igual (la
+    // tabla es duena de lo que guarda, por eso el suelto va adentro)
+    HashTable table;
+    State *loose = new State(5, jugs, 0, 0, nullptr);
+    assert(table.insert(loose));
+    assert(table.contains(root));
+    assert(!table.insert(root));
+
+    // sin tablas (capacidades enormes) las llaves son las mismas
+    unsigned int huge[2] = {4000000000u, 7};
+    ZobristHash untabled(huge, 2);
+    assert(untabled.keys == nullptr);
+    unsigned int big_jugs[2] = {3999999999u, 7};
+    assert(untabled.hashOf(big_jugs) == ZobristHash::computeFrom(big_jugs, 2));
+    assert(untabled.update(untabled.hashOf(big_jugs), 0, 3999999999u, 0) ==
+           (ZobristHash::mixKey(0, 0) ^ ZobristHash::mixKey(1, 7)));
+}